@@ -0,0 +1,10 @@
+//De pixeles a coordenadas normalizadas, el uniform buffer solo cambia al redimensionar la ventana
+layout (std140) uniform Projection
+{
+  mat4 projection;
+};
+
+vec4 pixelsToClip(vec2 pixels)
+{
+  return projection * vec4(pixels, 0.0, 1.0);
+}
@@ -2,15 +2,47 @@
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
+#if defined(TILEMAP)
+//Por instancia: columna y fila del tile dentro del chunk
+layout (location = 2) in uvec2 iTile;
+
+//Esquina de abajo a la izquierda del chunk y lado de un tile, en pixeles
+uniform vec2 chunkOrigin;
+uniform float tileSize;
+#elif defined(INSTANCED)
+//Por instancia: la matriz del sprite en pixeles (eje x, eje y y traslacion)
+layout (location = 2) in vec2 iModelX;
+layout (location = 3) in vec2 iModelY;
+layout (location = 4) in vec2 iModelT;
+#else
+//Matriz del objeto en pixeles, una por llamada
+uniform mat3x2 transform;
+#endif
+
+#ifdef UV_RECT
+//Trozo de la textura que se dibuja: abajo izquierda (xy) y arriba derecha (zw)
+uniform vec4 uvRect;
+#endif
+
 out vec2 VertexTexCoord;
 
-uniform mat4 transform;
+#include "projection.glsl"
 
 void main()
 {
-  vec4 position =  transform * vec4(aPos.x, aPos.y, 0.0, 1.0);
+#if defined(TILEMAP)
+  vec2 world = chunkOrigin + (vec2(iTile) + aPos + 0.5) * tileSize;
+#elif defined(INSTANCED)
+  vec2 world = iModelX * aPos.x + iModelY * aPos.y + iModelT;
+#else
+  vec2 world = transform * vec3(aPos, 1.0);
+#endif
+
+  gl_Position = pixelsToClip(world);
 
-  gl_Position = position;
-  
-  VertexTexCoord =  vec2(aTexCoord.x, aTexCoord.y);
+#ifdef UV_RECT
+  VertexTexCoord = mix(uvRect.xy, uvRect.zw, aTexCoord);
+#else
+  VertexTexCoord = aTexCoord;
+#endif
 }
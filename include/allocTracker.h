@@ -0,0 +1,68 @@
+#ifndef ALLOC_TRACKER
+#define ALLOC_TRACKER
+
+#include <cstdint>
+#include <cstdio>
+
+//Contador de reservas de memoria del bucle principal
+//Solo funciona si se compila con TRACK_ALLOCATIONS (opcion TETRIS_TRACK_ALLOCATIONS de cmake), en ese caso
+//se sustituyen los operator new/delete globales. Sin la opcion todo son funciones vacias
+//Con NDEBUG sin definir tambien se guarda un histograma por direccion desde donde se llama a new
+
+struct AllocStats{
+   uint64_t allocations;
+   uint64_t frees;
+   uint64_t bytes;
+};
+
+enum BUDGET_ACTION{ budgetLog, budgetAssert };
+
+const int MAX_ALLOC_ZONES = 32;
+
+class AllocTracker{
+public:
+   static bool enabled();
+
+   //Delimitan un frame, endFrame comprueba el presupuesto y devuelve lo que se ha reservado en el frame
+   static void beginFrame();
+   static AllocStats endFrame();
+
+   //Maximo de reservas y bytes por frame, 0 es sin limite
+   static void setBudget(uint64_t maxAllocations, uint64_t maxBytes, BUDGET_ACTION action);
+
+   static AllocStats lastFrame();
+   static AllocStats total();
+
+   //Tabla de zonas del ultimo frame y, en debug, las direcciones que mas reservan
+   static void printReport(FILE* file);
+};
+
+//Zona del profiler: lo que se reserva en este hilo mientras existe se apunta a su nombre
+//El nombre tiene que vivir todo el programa (un literal)
+class AllocZone{
+public:
+#ifdef TRACK_ALLOCATIONS
+   AllocZone(const char* name);
+   ~AllocZone();
+
+private:
+   int previous;
+#else
+   AllocZone(const char*){}
+#endif
+
+   AllocZone(const AllocZone&) = delete;
+   AllocZone& operator=(const AllocZone&) = delete;
+};
+
+#ifndef TRACK_ALLOCATIONS
+inline bool AllocTracker::enabled(){ return false; }
+inline void AllocTracker::beginFrame(){}
+inline AllocStats AllocTracker::endFrame(){ return AllocStats{}; }
+inline void AllocTracker::setBudget(uint64_t, uint64_t, BUDGET_ACTION){}
+inline AllocStats AllocTracker::lastFrame(){ return AllocStats{}; }
+inline AllocStats AllocTracker::total(){ return AllocStats{}; }
+inline void AllocTracker::printReport(FILE*){}
+#endif
+
+#endif
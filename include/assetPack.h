@@ -0,0 +1,113 @@
+#ifndef ASSET_PACK
+#define ASSET_PACK
+
+#include "include/mappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Formato del pack de assets (assets.pak), little endian:
+//  cabecera: AssetPackHeader (32 bytes)
+//  indice:   tableSize entradas AssetPackEntry, tabla hash con sondeo lineal (hash 0 es un hueco vacio)
+//  nombres:  los nombres seguidos, sin terminar en 0
+//  datos:    cada asset alineado a 16 bytes
+//Los nombres son la ruta dentro de la carpeta assets ("shader/shader.vs", "textures/redTile.png")
+//Las imagenes se guardan ya horneadas (formato .tex de bakedTexture.h), el resto tal cual
+const uint32_t ASSET_PACK_VERSION = 1;
+const char* const ASSET_PACK_NAME = "assets.pak";
+
+struct AssetPackHeader{
+   char magic[4];
+   uint32_t version;
+   uint32_t entryCount;
+   uint32_t tableSize;
+   uint64_t namesOffset;
+   uint64_t reserved;
+};
+static_assert(sizeof(AssetPackHeader) == 32, "La cabecera del pack ocupa 32 bytes");
+
+struct AssetPackEntry{
+   uint64_t hash;
+   uint64_t offset;
+   uint64_t size;
+   uint32_t nameOffset;
+   uint32_t nameLength;
+};
+static_assert(sizeof(AssetPackEntry) == 32, "Las entradas del indice ocupan 32 bytes");
+
+//FNV-1a de 64 bits, nunca devuelve 0
+uint64_t assetNameHash(std::string_view name);
+
+//Carpeta del ejecutable acabada en '/', los assets y las caches van relativos a ella
+std::string executableDirectory();
+
+//Trozo de un archivo proyectado, no es dueño de la memoria
+struct AssetSpan{
+   const uint8_t* data = nullptr;
+   size_t size = 0;
+
+   explicit operator bool() const { return data != nullptr; }
+   std::string_view text() const { return std::string_view((const char*)data, size); }
+};
+
+//Pack abierto una sola vez con mmap, find no copia nada
+class AssetPack{
+public:
+   AssetPack(): header(nullptr), table(nullptr){}
+
+   //Devuelve false si no existe o no es valido, comprueba todas las entradas al abrir
+   bool open(const std::string& path);
+   bool isOpen() const { return header != nullptr; }
+
+   //Span vacio si no esta en el pack
+   AssetSpan find(std::string_view name) const;
+   uint32_t size() const { return header ? header->entryCount : 0; }
+
+private:
+   MappedFile file;
+   const AssetPackHeader* header;
+   const AssetPackEntry* table;
+};
+
+//Junta assets en memoria y escribe el pack, lo usa assetbaker
+class AssetPackWriter{
+public:
+   void add(std::string name, std::vector<uint8_t> data);
+   bool write(const std::string& path) const;
+
+private:
+   struct PendingAsset{
+      std::string name;
+      std::vector<uint8_t> data;
+   };
+
+   std::vector<PendingAsset> assets;
+};
+
+//Un asset por nombre: del pack que esta al lado del ejecutable o, si no hay pack o no esta dentro,
+//del archivo suelto en la carpeta assets (../assets desde el ejecutable). No depende del directorio de trabajo
+class Asset{
+public:
+   bool load(std::string_view name);
+   //Solo el archivo suelto, para recargar un asset que se ha editado
+   bool loadFile(std::string_view name);
+
+   const uint8_t* data() const { return span.data; }
+   size_t size() const { return span.size; }
+   std::string_view text() const { return span.text(); }
+   bool fromPack() const { return span && !file.isOpen(); }
+
+   //El pack compartido, se abre la primera vez que se pide
+   static const AssetPack& pack();
+   //Ruta del archivo suelto que corresponde a un nombre
+   static std::string loosePath(std::string_view name);
+
+private:
+   AssetSpan span;
+   MappedFile file;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef ASSET_WATCHER
+#define ASSET_WATCHER
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+//Vigila con inotify las subcarpetas de la carpeta de assets sueltos desde un hilo aparte
+//Los archivos que se guardan se apuntan por su nombre de asset ("shader/shader.fs") y el hilo de OpenGL los recoge con takeChanges
+//El hilo esta dormido en poll() mientras no cambia nada, y takeChanges sin cambios es solo leer un atomico
+class AssetWatcher{
+public:
+   AssetWatcher();
+   ~AssetWatcher();
+
+   AssetWatcher(const AssetWatcher&) = delete;
+   AssetWatcher& operator=(const AssetWatcher&) = delete;
+
+   //root acabada en '/', devuelve false si no hay ninguna carpeta que vigilar
+   bool start(const std::string& root);
+   void stop();
+   bool isRunning() const { return thread.joinable(); }
+
+   //Mueve a changed los nombres cambiados desde la ultima llamada (sin repetir), false si no hay ninguno
+   bool takeChanges(std::vector<std::string>& changed);
+
+private:
+   void run();
+
+   int inotifyDescriptor;
+   int wakeDescriptor;
+   std::thread thread;
+
+   //Descriptor de cada carpeta vigilada y su nombre dentro de assets
+   std::vector<std::pair<int, std::string>> directories;
+
+   std::mutex pendingMutex;
+   std::vector<std::string> pending;
+   std::atomic<bool> hasPending;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef BITBOARD
+#define BITBOARD
+
+#include "include/board.h"
+#include "include/movingPiece.h"
+
+#include <cstdint>
+
+//Forma de una pieza como mascaras de bits, una por fila (bit i = columna i de la pieza)
+struct PieceMask{
+    uint16_t rows[4];
+    int size;
+};
+
+//Caracteristicas clasicas para puntuar un tablero
+struct BoardFeatures{
+    int aggregateHeight;
+    int holes;
+    int bumpiness;
+};
+
+//Tablero de ocupacion con una fila por uint16_t (bit x = columna x)
+//Las 4 primeras filas son relleno vacio para que las 20 del tablero ocupen 3 registros de 128 bits
+struct alignas(16) Bitboard{
+    static const int padding = 4;
+    static const uint16_t fullRow = 0x3FF;
+
+    uint16_t rows[24];
+
+    Bitboard();
+    Bitboard(const Board& board);
+
+    uint16_t& row(int y){ return rows[padding + y]; }
+    uint16_t row(int y) const { return rows[padding + y]; }
+
+    bool fits(const PieceMask& piece, int x, int y) const;
+    int dropRow(const PieceMask& piece, int x, int y) const;
+    void place(const PieceMask& piece, int x, int y);
+    int clearLines();
+
+    BoardFeatures features() const;
+};
+
+PieceMask pieceMaskFromPiece(const MovingPiece& movingPiece);
+PieceMask rotatePieceMask(const PieceMask& piece);
+
+#endif 
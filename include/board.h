@@ -1,10 +1,9 @@
 #ifndef BOARD
 #define BOARD
-#include "include/engine.h"
-#include "include/rendering/sprite.h"
 #include "include/piece.h"
 
 #include "iostream"
+#include <cstdint>
 #include <vector>
 
 //Clase para representar el tablero
@@ -13,6 +12,17 @@ public:
     Board();
 
     Piece pieces[10][20];
+
+    //Altura de cada columna contando solo las piezas estaticas (0 = vacia, 20 = llena)
+    int heights[10];
+
+    void lockCell(int x, int y, COLOR color);
+    void clearRow(int row);
+    void reset();
+
+    int dropRow(int x, int y, uint16_t shape, int size);
+
+    uint64_t hash() const;
 };
 
 #endif 
@@ -0,0 +1,39 @@
+#ifndef BOT
+#define BOT
+
+#include "include/bitboard.h"
+#include "include/policy.h"
+#include "include/simulation.h"
+
+#include <cstdint>
+
+//Una colocacion posible de la pieza: su forma ya rotada y la columna
+struct Placement{
+    PieceMask piece;
+    int x;
+    double score;
+};
+
+//Jugador automatico: prueba todas las colocaciones de la pieza actual y la siguiente y se queda con la mejor
+class Bot : public IPolicy{
+public:
+    Bot(): evaluatedPlacements(0), hasPlan(false), plannedPiece(0), lastTick(0){};
+
+    INPUT nextInput(const Simulation& simulation) override;
+
+    Placement findPlacement(const Simulation& simulation);
+
+    //Cuantos tableros ha puntuado en total
+    uint64_t evaluatedPlacements;
+
+private:
+    bool hasPlan;
+    int plannedPiece;
+    uint64_t lastTick;
+    Placement plan;
+
+    double bestScore(const Bitboard& board, const PieceMask& piece);
+    double evaluate(const Bitboard& board, int lines);
+};
+
+#endif 
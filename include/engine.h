@@ -2,8 +2,15 @@
 #define SPRITE_H
 
 #include "include/glm/ext/vector_float2.hpp"
-#include "include/rendering/sprite.h"
+#include "include/rendering/camera2D.h"
+#include "include/rendering/spriteStore.h"
+#include "include/rendering/spriteRenderer.h"
+#include "include/rendering/tilemap.h"
+#include "include/rendering/tilemapRenderer.h"
 #include "include/rendering/text.h"
+#include "include/rendering/textureManager.h"
+#include "include/myLibs/slotMap.h"
+#include "include/assetWatcher.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -11,6 +18,15 @@
 #include <functional>
 #include <vector>
 
+//Lo que se ha dibujado y lo que se ha descartado por estar fuera de la vista en el ultimo frame
+struct RenderStats{
+    uint32_t drawnSprites = 0, culledSprites = 0;
+    uint32_t drawnTexts = 0, culledTexts = 0;
+    uint32_t drawnChunks = 0, culledChunks = 0;
+    //Sin contar las de cada caracter de los textos, un texto cuenta como una
+    int drawCalls = 0;
+};
+
 class IUpdateSubscriber{
 public:
     virtual void update() = 0;
@@ -26,12 +42,27 @@ public:
     Engine(int window_width, int window_heigth);
 
     void Init();
-    Sprite* addSprite(std::string pathToTexture,float xPos, float yPos, float width, float heigth);
-    void addSprite(Sprite* sprite);
-    void removeSprite(Sprite* sprite);
-    Text* addText(std::string text, int xPos, int yPos, int height);
+    //El fondo esta en la capa 0, el resto de sprites van por defecto en la 1
+    //Las texturas se piden por nombre de asset ("textures/redTile.png"), ver assetPack.h
+    SpriteHandle addSprite(std::string textureName,float xPos, float yPos, float width, float heigth, uint8_t layer = 1);
+    SpriteHandle addSprite(unsigned int texture,float xPos, float yPos, float width, float heigth, uint8_t layer = 1);
+    //Cada sprite tiene una referencia a su textura, removeSprite la suelta
+    void removeSprite(SpriteHandle sprite);
+    //Para cambiar la posicion, textura... de los sprites a partir de su handle
+    //setTexture del store no mueve las referencias: la textura nueva tiene que seguir cargada mientras se use
+    SpriteStore& getSprites(){ return sprites; }
+    Text* addText(std::string_view text, int xPos, int yPos, int height);
+    //Rejilla de tiles de width x height, origin es la esquina de abajo a la izquierda en pixeles
+    //Se dibujan encima de los sprites. El engine la borra en stopEngine o en removeTilemap
+    Tilemap* addTilemap(uint32_t width, uint32_t height, float tileSize, glm::vec2 origin);
+    void removeTilemap(Tilemap* tilemap);
 
     glm::vec2 getWindowSize();
+    //Los sprites y tilemaps se ven a traves de la camara, los textos no
+    Camera2D& getCamera(){ return camera; }
+    //Donde esta el raton en pixeles del mundo, para getSprites().pick
+    glm::vec2 getCursorWorldPosition();
+    const RenderStats& getRenderStats() const { return stats; }
     void stopEngine();
     void pauseEngine() {pause_thread = true;}
     void resumeEngine() {pause_thread = false;}
@@ -39,16 +70,35 @@ public:
     void addInputCallBack(IInputSubscriber*);
     void addUpdateCallBack(IUpdateSubscriber*);
 
-    unsigned int createRGBATexture(std::string pathToTexture);
-    unsigned int createRGBTexture(std::string pathToTexture);
+    //Atajos que devuelven el id de OpenGL, la textura se queda cargada hasta stopEngine
+    unsigned int createRGBATexture(std::string textureName);
+    unsigned int createRGBTexture(std::string textureName);
+    //Para elegir formato, filtro y mipmaps, y soltar las texturas que ya no se usan
+    TextureManager& getTextures(){ return textures; }
+
+    //Recarga los shaders y texturas cuando se guardan los archivos de la carpeta assets
+    //Hay que llamarlo antes de cargar las texturas, las de antes pueden estar compartidas con otro nombre y no se recargan
+    void enableHotReload();
 
     bool isClosed(){ return glfwWindowShouldClose(_window);};
 
 private: 
-    std::vector<Sprite*> sprites;
+    SpriteStore sprites;
+    SpriteRenderer* spriteRenderer;
     std::vector<Text*> texts;
-
-    Sprite* background;
+    TilemapRenderer* tilemapRenderer;
+    std::vector<Tilemap*> tilemaps;
+
+    SpriteHandle background;
+    Camera2D camera;
+    uint32_t uploadedCameraRevision = 0;
+    RenderStats stats;
+    TextureManager textures;
+    TextureHandle bitmapFont;
+
+    AssetWatcher assetWatcher;
+    std::vector<std::string> changedAssets;
+    void reloadChangedAssets();
 
     bool editing_sprites = false;
     bool pause_thread = false;
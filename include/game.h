@@ -1,13 +1,13 @@
 #ifndef GAME
 #define GAME 
 #include "include/engine.h"
-#include "include/rendering/sprite.h"
 #include "include/piece.h"
 #include "include/rendering/text.h"
-#include "include/rendering/tileSprite.h"
 #include "include/board.h"
 #include "include/movingPiece.h"
-#include "include/staticPiece.h"
+#include "include/simulation.h"
+#include "include/policy.h"
+#include "include/replay.h"
 #include <iostream>
 #include <vector>
 
@@ -20,27 +20,38 @@ public:
 
     void processInput(int key) override;
 
+    //Sustituye al teclado por otra fuente de input (por ejemplo el bot), nullptr vuelve al teclado
+    void setInputSource(IPolicy* source){ inputSource = source; }
+
+    //Graba el input de la partida actual hasta que se pierda o se llame a stopRecording
+    void startRecording(ReplayRecorder* newRecorder);
+    void stopRecording();
+
+    //Juega una repeticion en vez de leer el teclado, al acabar vuelve a empezar
+    void playReplay(ReplayPlayer* player);
+
 private:
-    int keyToProcess;
+    INPUT inputToProcess = inputNone;
+    IPolicy* inputSource = nullptr;
+    ReplayRecorder* recorder = nullptr;
+    ReplayPlayer* replay = nullptr;
+
+    //Estado al empezar la partida, para volver a intentarla al instante
+    GameState startState;
+    bool retryRequested = false;
+    void retry();
     double lastTime = 0;
-    double timeToPass = 0.25;
-
-    int points;
 
     Engine* engine;
-    TileSprite* tiles[10][20];
-    std::vector<StaticPiece> staticPieces;
-    Board board;
-    MovingPiece* movingPiece;
-
-    void movePiece();
-    void placePiece();
-    void deleteRow(int row);
-    void gameOver();
+    //El tablero, la fila 0 del tilemap es la de abajo (la 19 del Board)
+    Tilemap* tiles;
+    void setTile(int x, int y, uint16_t tile);
+    Simulation simulation;
 
-    unsigned int texutres[5];
+    void gameOver();
 
-    bool isValidMove(int newX, int newY, std::vector<std::vector<int>>& structure);
+    //Indice de la sombra en la paleta del tablero, los colores usan su propio valor
+    static const uint16_t ghostTile = 5;
 
     Text* textRenderer;
 };
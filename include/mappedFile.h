@@ -0,0 +1,34 @@
+#ifndef MAPPED_FILE
+#define MAPPED_FILE
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//Archivo de solo lectura proyectado en memoria (mmap), las paginas se leen del disco la primera vez que se tocan
+//Los punteros que devuelve data() son validos hasta close() o hasta que se destruye
+class MappedFile{
+public:
+   MappedFile(): bytes(nullptr), length(0){}
+   ~MappedFile(){ close(); }
+
+   MappedFile(const MappedFile&) = delete;
+   MappedFile& operator=(const MappedFile&) = delete;
+
+   MappedFile(MappedFile&& other);
+   MappedFile& operator=(MappedFile&& other);
+
+   //Devuelve false si el archivo no existe, esta vacio o no se puede proyectar
+   bool open(const std::string& path);
+   void close();
+
+   bool isOpen() const { return bytes != nullptr; }
+   const uint8_t* data() const { return bytes; }
+   size_t size() const { return length; }
+
+private:
+   const uint8_t* bytes;
+   size_t length;
+};
+
+#endif
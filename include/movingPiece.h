@@ -3,23 +3,31 @@
 
 #include "include/board.h"
 #include "include/piece.h"
+#include "include/random.h"
 
+#include <cstdint>
 #include <iostream>
 
 class MovingPiece{
 public:
     MovingPiece();
+    MovingPiece(Random& random);
 
     int currentX, currentY;
 
-    std::vector<std::vector<int>> currentStruct;
+    //La forma de la pieza en 4x4 casillas, la casilla (i, j) es el bit i + 4 * j
+    //Solo se usan las primeras size filas y columnas
+    uint16_t shape;
+    int size;
+
+    bool cell(int i, int j) const { return (shape >> (i + 4 * j)) & 1; }
 
     COLOR color;
 
-    void rotateLeft(Piece currentBoard[10][20]);
+    bool rotateLeft(Piece currentBoard[10][20]);
     void moveLeft();
     void moveRigth();
-    bool moveDown(Board *board);
+    void moveDown(Board *board);
 };
 
 #endif
@@ -1,81 +1,381 @@
-#ifndef HASH_MAP 
-#define HASH_MAP 
+#ifndef HASH_MAP
+#define HASH_MAP
 
-#include <stdlib.h>
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
-using namespace std;
+//Hash para claves de texto que permite buscar con std::string, std::string_view o const char* sin crear strings
+//Se usa junto a std::equal_to<>: HashMap<std::string, D, StringHash, std::equal_to<>>
+struct StringHash{
+    using is_transparent = void;
 
-template<typename K,typename D>
-struct node{
-    K key;
-    D data;
-    node *nextNode;
+    size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
 };
 
-// New node creation
-template<typename K,typename D>
+//Tabla hash de direccionamiento abierto con Robin Hood hashing
+//Los elementos estan en un solo array y se buscan recorriendo casillas contiguas
+//Cada casilla guarda en un byte a que distancia esta de su casilla ideal (0 = vacia), al borrar se desplazan hacia atras
+//Insertar o borrar invalida los iteradores y punteros a elementos, salvo el iterador que devuelve erase(iterator):
+//se puede borrar mientras se recorre la tabla y cada elemento se visita una sola vez
+template<typename K, typename D, typename Hash = std::hash<K>, typename Equal = std::equal_to<K>>
 class HashMap{
 public:
-    HashMap(): firstNode(nullptr){}
+    typedef std::pair<K, D> value_type;
 
-    HashMap(std::initializer_list<std::pair<K, D>> list) : firstNode(nullptr) {
-        for (const auto& pair : list) {
-            AddNode(pair.first, pair.second);
-        }
-    }
+    template<bool Const>
+    class Iterator{
+    public:
+        typedef typename std::conditional<Const, const HashMap*, HashMap*>::type MapPointer;
+        typedef typename std::conditional<Const, const value_type, value_type>::type Entry;
+
+        Iterator(MapPointer map, size_t start, size_t position): map(map), start(start), position(position){ skipEmpty(); }
 
-    void AddNode(K key, D data){
-        if (firstNode == nullptr){
-            firstNode = NewNode(key, data);
-            return;
+        //Para pasar de iterator a const_iterator
+        template<bool C = Const, typename = typename std::enable_if<!C>::type>
+        operator Iterator<true>() const { return Iterator<true>(map, start, position); }
+
+        Entry& operator*() const { return map->entries[slot()]; }
+        Entry* operator->() const { return &map->entries[slot()]; }
+
+        Iterator& operator++(){
+            position++;
+            skipEmpty();
+            return *this;
         }
 
-        node<K, D>* currentNode = firstNode;
-        while (currentNode->nextNode != nullptr){
-           currentNode = currentNode->nextNode; 
+        bool operator==(const Iterator& other) const { return position == other.position; }
+        bool operator!=(const Iterator& other) const { return position != other.position; }
+
+    private:
+        //El recorrido empieza en una casilla vacia y da la vuelta a la tabla, position es cuanto se ha avanzado desde ella
+        //Al borrar los elementos se mueven hacia atras y nunca pasan por una casilla vacia, asi que con este orden
+        //solo pueden moverse a la casilla que se acaba de borrar, nunca a una ya visitada ni saltar al principio
+        MapPointer map;
+        size_t start;
+        size_t position;
+
+        size_t slot() const { return (start + position) & (map->capacity - 1); }
+
+        void skipEmpty(){
+            while (position < map->capacity && map->distances[slot()] == 0)
+                position++;
         }
 
-        currentNode->nextNode = NewNode(key, data);
+        friend class HashMap;
     };
 
-    bool HasKey(K key){
-        node<K, D>* currentNode = firstNode;
-        while (currentNode->nextNode != nullptr){
-            if (currentNode->key == key){
-                return true;
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    HashMap(): entries(nullptr), distances(nullptr), capacity(0), count(0), shift(64), maxDistance(0), emptySlot(0){}
+
+    HashMap(std::initializer_list<value_type> list): HashMap(){
+        reserve(list.size());
+        for (const value_type& pair : list)
+            insert(pair.first, pair.second);
+    }
+
+    HashMap(const HashMap& other): HashMap(){
+        reserve(other.count);
+        for (const value_type& pair : other)
+            insert(pair.first, pair.second);
+    }
+
+    HashMap(HashMap&& other) noexcept: HashMap(){
+        swap(other);
+    }
+
+    HashMap& operator=(HashMap other) noexcept{
+        swap(other);
+        return *this;
+    }
+
+    ~HashMap(){
+        clear();
+        release();
+    }
+
+    void swap(HashMap& other) noexcept{
+        std::swap(entries, other.entries);
+        std::swap(distances, other.distances);
+        std::swap(capacity, other.capacity);
+        std::swap(count, other.count);
+        std::swap(shift, other.shift);
+        std::swap(maxDistance, other.maxDistance);
+        std::swap(emptySlot, other.emptySlot);
+    }
+
+    //Busqueda, las versiones con plantilla solo existen si Hash y Equal son transparentes
+    iterator find(const K& key){ return iteratorAt<false>(findIndex(key)); }
+    const_iterator find(const K& key) const { return iteratorAt<true>(findIndex(key)); }
+
+    template<typename Q, typename H = Hash, typename E = Equal, typename = typename H::is_transparent, typename = typename E::is_transparent>
+    iterator find(const Q& key){ return iteratorAt<false>(findIndex(key)); }
+
+    template<typename Q, typename H = Hash, typename E = Equal, typename = typename H::is_transparent, typename = typename E::is_transparent>
+    const_iterator find(const Q& key) const { return iteratorAt<true>(findIndex(key)); }
+
+    bool contains(const K& key) const { return findIndex(key) != capacity; }
+
+    template<typename Q, typename H = Hash, typename E = Equal, typename = typename H::is_transparent, typename = typename E::is_transparent>
+    bool contains(const Q& key) const { return findIndex(key) != capacity; }
+
+    D& at(const K& key){
+        size_t index = findIndex(key);
+        if (index == capacity)
+            throw std::out_of_range("La key no existe");
+
+        return entries[index].second;
+    }
+
+    const D& at(const K& key) const{
+        size_t index = findIndex(key);
+        if (index == capacity)
+            throw std::out_of_range("La key no existe");
+
+        return entries[index].second;
+    }
+
+    //Si la key no existe se crea con el valor por defecto
+    D& operator[](const K& key){ return try_emplace(key).first->second; }
+    D& operator[](K&& key){ return try_emplace(std::move(key)).first->second; }
+
+    //Inserta solo si la key no existe, devuelve el elemento y si se ha insertado
+    std::pair<iterator, bool> insert(const K& key, const D& data){ return try_emplace(key, data); }
+    std::pair<iterator, bool> insert(K&& key, D&& data){ return try_emplace(std::move(key), std::move(data)); }
+
+    template<typename KK, typename... Args>
+    std::pair<iterator, bool> try_emplace(KK&& key, Args&&... args){
+        size_t index = findIndex(key);
+        if (index != capacity)
+            return std::make_pair(iteratorAt<false>(index), false);
+
+        if ((count + 1) * 8 > capacity * 7 || maxDistance >= 254)
+            grow();
+
+        index = place(value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KK>(key)), std::forward_as_tuple(std::forward<Args>(args)...)));
+        return std::make_pair(iteratorAt<false>(index), true);
+    }
+
+    bool erase(const K& key){
+        size_t index = findIndex(key);
+        if (index == capacity)
+            return false;
+
+        eraseIndex(index);
+        return true;
+    }
+
+    iterator erase(const_iterator position){
+        eraseIndex(position.slot());
+
+        //El siguiente elemento puede haberse movido a esta casilla
+        return iterator(this, position.start, position.position);
+    }
+
+    //Reserva sitio para n elementos sin tener que volver a redistribuir
+    void reserve(size_t n){
+        size_t needed = 8;
+        while (needed * 7 < n * 8)
+            needed *= 2;
+
+        if (needed > capacity)
+            rehash(needed);
+    }
+
+    void clear(){
+        for (size_t i = 0; i < capacity; i++){
+            if (distances[i] != 0){
+                entries[i].~value_type();
+                distances[i] = 0;
             }
-            currentNode = currentNode->nextNode; 
         }
 
-        return false;
-    };
+        count = 0;
+        maxDistance = 0;
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    iterator begin(){ return iterator(this, emptySlot, 0); }
+    iterator end(){ return iterator(this, emptySlot, capacity); }
+    const_iterator begin() const { return const_iterator(this, emptySlot, 0); }
+    const_iterator end() const { return const_iterator(this, emptySlot, capacity); }
+
+private:
+    value_type* entries;
+    uint8_t* distances;
+    size_t capacity;
+    size_t count;
+    int shift;
+    int maxDistance;
+    //Una casilla vacia, donde empiezan los recorridos. Siempre hay alguna porque la tabla nunca se llena
+    size_t emptySlot;
+
+    //Iterador a una casilla, o end() si es capacity
+    template<bool Const>
+    Iterator<Const> iteratorAt(size_t index) const{
+        typedef typename Iterator<Const>::MapPointer MapPointer;
+        size_t position = index == capacity ? capacity : (index - emptySlot) & (capacity - 1);
+        return Iterator<Const>(const_cast<MapPointer>(this), emptySlot, position);
+    }
+
+    //Multiplicacion de Fibonacci para repartir bien tambien los hash que son la propia key (int, char...)
+    template<typename Q>
+    size_t idealIndex(const Q& key) const{
+        return size_t((uint64_t(Hash{}(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
 
-    D& operator[](const K& key) {
-        node<K, D>* currentNode = firstNode;
-        while (currentNode != nullptr) {
-            if (currentNode->key == key) {
-                return currentNode->data;
+    //Devuelve capacity si no esta
+    template<typename Q>
+    size_t findIndex(const Q& key) const{
+        if (count == 0)
+            return capacity;
+
+        size_t mask = capacity - 1;
+        size_t index = idealIndex(key);
+
+        //Con Robin Hood se puede parar en cuanto una casilla esta mas cerca de su sitio que la key buscada
+        for (int distance = 1; distance <= distances[index]; distance++){
+            if (distances[index] == distance && Equal{}(entries[index].first, key))
+                return index;
+
+            index = (index + 1) & mask;
+        }
+
+        return capacity;
+    }
+
+    //Coloca un elemento que no esta en la tabla y devuelve su casilla
+    size_t place(value_type&& value){
+        size_t mask = capacity - 1;
+        size_t index = idealIndex(value.first);
+        size_t result = capacity;
+        int distance = 1;
+
+        value_type carried(std::move(value));
+
+        while (true){
+            if (distances[index] == 0){
+                new (&entries[index]) value_type(std::move(carried));
+                distances[index] = uint8_t(distance);
+                if (distance > maxDistance)
+                    maxDistance = distance;
+                if (result == capacity)
+                    result = index;
+                if (index == emptySlot)
+                    findEmptySlot();
+                break;
             }
-            currentNode = currentNode->nextNode;
+
+            //El que esta mas cerca de su sitio cede la casilla
+            if (distances[index] < distance){
+                std::swap(carried, entries[index]);
+
+                int previous = distances[index];
+                distances[index] = uint8_t(distance);
+                if (distance > maxDistance)
+                    maxDistance = distance;
+                distance = previous;
+
+                if (result == capacity)
+                    result = index;
+            }
+
+            index = (index + 1) & mask;
+            distance++;
         }
 
-        throw std::out_of_range("La key no existe");
+        count++;
+        return result;
     }
 
-private:
-    node<K, D>* firstNode;
+    //Borra y mueve hacia atras los elementos que estaban desplazados
+    void eraseIndex(size_t index){
+        size_t mask = capacity - 1;
+
+        entries[index].~value_type();
+        distances[index] = 0;
+        count--;
+
+        size_t next = (index + 1) & mask;
+        while (distances[next] > 1){
+            new (&entries[index]) value_type(std::move(entries[next]));
+            entries[next].~value_type();
+
+            distances[index] = distances[next] - 1;
+            distances[next] = 0;
+
+            index = next;
+            next = (next + 1) & mask;
+        }
+    }
+
+    //Sigue desde la anterior, cualquier casilla vacia sirve
+    void findEmptySlot(){
+        while (distances[emptySlot] != 0)
+            emptySlot = (emptySlot + 1) & (capacity - 1);
+    }
+
+    void grow(){
+        int previousMax = maxDistance;
+        rehash(capacity == 0 ? 8 : capacity * 2);
+
+        //Muchisimas keys con el mismo hash, doblar la tabla no sirve
+        if (maxDistance >= 254 && maxDistance >= previousMax)
+            throw std::length_error("Demasiadas keys con el mismo hash");
+    }
+
+    void rehash(size_t newCapacity){
+        value_type* oldEntries = entries;
+        uint8_t* oldDistances = distances;
+        size_t oldCapacity = capacity;
+
+        entries = std::allocator<value_type>().allocate(newCapacity);
+        distances = new uint8_t[newCapacity]();
+        capacity = newCapacity;
+        count = 0;
+        maxDistance = 0;
+        emptySlot = 0;
 
-    node<K, D>* NewNode(K key, D data){
-        node<K, D>* node = new ::node<K, D>();
+        shift = 64;
+        for (size_t size = newCapacity; size > 1; size >>= 1)
+            shift--;
 
-        node->key = key;
-        node->data = data;
+        for (size_t i = 0; i < oldCapacity; i++){
+            if (oldDistances[i] != 0){
+                place(std::move(oldEntries[i]));
+                oldEntries[i].~value_type();
+            }
+        }
+
+        if (oldEntries != nullptr)
+            std::allocator<value_type>().deallocate(oldEntries, oldCapacity);
+        delete[] oldDistances;
+
+        findEmptySlot();
+    }
 
-        node->nextNode = nullptr;
+    void release(){
+        if (entries != nullptr)
+            std::allocator<value_type>().deallocate(entries, capacity);
+        delete[] distances;
 
-        return node;
+        entries = nullptr;
+        distances = nullptr;
+        capacity = 0;
+        emptySlot = 0;
     }
 };
 
-#endif 
+#endif
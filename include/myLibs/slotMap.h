@@ -0,0 +1,120 @@
+#ifndef SLOT_MAP
+#define SLOT_MAP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Referencia a un elemento de un SlotMap, deja de ser valida cuando se elimina el elemento
+struct SlotHandle{
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+};
+
+//Contenedor con insercion y borrado O(1) y los elementos contiguos en memoria
+//Los handles llevan una generacion, asi un handle de un elemento borrado nunca apunta a otro nuevo
+//Borrar mueve el ultimo elemento al hueco, por lo que los punteros a elementos no son estables
+template<typename T>
+class SlotMap{
+public:
+    SlotMap(): freeHead(noSlot){}
+
+    SlotHandle insert(T&& value){
+        uint32_t index;
+        if (freeHead != noSlot){
+            index = freeHead;
+            freeHead = slots[index].denseIndex;
+        }else{
+            index = uint32_t(slots.size());
+            slots.push_back(Slot{ 0, 1 });
+        }
+
+        slots[index].denseIndex = uint32_t(items.size());
+        items.push_back(std::move(value));
+        itemSlots.push_back(index);
+
+        return SlotHandle{ index, slots[index].generation };
+    }
+
+    bool remove(SlotHandle handle){
+        if (!contains(handle))
+            return false;
+
+        Slot& slot = slots[handle.index];
+        uint32_t last = uint32_t(items.size() - 1);
+
+        //El ultimo elemento ocupa el hueco para que no queden huecos
+        if (slot.denseIndex != last){
+            items[slot.denseIndex] = std::move(items[last]);
+            itemSlots[slot.denseIndex] = itemSlots[last];
+            slots[itemSlots[slot.denseIndex]].denseIndex = slot.denseIndex;
+        }
+        items.pop_back();
+        itemSlots.pop_back();
+
+        slot.generation++;
+        slot.denseIndex = freeHead;
+        freeHead = handle.index;
+
+        return true;
+    }
+
+    bool contains(SlotHandle handle) const{
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation && handle.generation != 0;
+    }
+
+    //Devuelve nullptr si el handle ya no es valido
+    T* get(SlotHandle handle){
+        if (!contains(handle))
+            return nullptr;
+
+        return &items[slots[handle.index].denseIndex];
+    }
+
+    const T* get(SlotHandle handle) const{
+        if (!contains(handle))
+            return nullptr;
+
+        return &items[slots[handle.index].denseIndex];
+    }
+
+    void reserve(size_t capacity){
+        items.reserve(capacity);
+        itemSlots.reserve(capacity);
+        slots.reserve(capacity);
+    }
+
+    void clear(){
+        while (!items.empty())
+            remove(SlotHandle{ itemSlots.back(), slots[itemSlots.back()].generation });
+    }
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    //Recorrido de los elementos en el orden en el que estan en memoria
+    typename std::vector<T>::iterator begin(){ return items.begin(); }
+    typename std::vector<T>::iterator end(){ return items.end(); }
+    typename std::vector<T>::const_iterator begin() const{ return items.begin(); }
+    typename std::vector<T>::const_iterator end() const{ return items.end(); }
+
+private:
+    static const uint32_t noSlot = UINT32_MAX;
+
+    //Si el slot esta libre denseIndex es el siguiente slot libre
+    struct Slot{
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    std::vector<T> items;
+    std::vector<uint32_t> itemSlots;
+    std::vector<Slot> slots;
+    uint32_t freeHead;
+};
+
+#endif 
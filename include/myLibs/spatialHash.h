@@ -0,0 +1,413 @@
+#ifndef SPATIAL_HASH
+#define SPATIAL_HASH
+
+#include "include/myLibs/hashMap.h"
+#include "include/glm/ext/vector_float2.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Rejilla infinita de celdas cuadradas guardada en un HashMap: cada celda tiene la lista de ids cuyas cajas (AABB) la tocan
+//Solo existen las celdas que tienen algo, el espacio es proporcional a los elementos y no al tamaño del mundo
+//Mover un elemento sin cambiar de celdas solo cambia su caja; si cambia de celdas se quita de las viejas y se pone en las nuevas
+//Los elementos que tocan muchas celdas (un fondo, por ejemplo) van a una lista aparte que se mira en todas las consultas
+//Las consultas no reservan memoria, pero marcan los elementos que ya han visto, asi que no se pueden hacer desde dos hilos a la vez
+class SpatialHash{
+public:
+    //Lo ideal es que la celda sea un poco mas grande que los elementos normales
+    explicit SpatialHash(float cellSize = 64): cellSize(cellSize), inverseCellSize(1.0f / cellSize), queryStamp(0){}
+
+    //Los ids son indices pequeños (por ejemplo el slot de un SlotMap), se guarda un elemento por id
+    void insert(uint32_t id, glm::vec2 min, glm::vec2 max){
+        if (id >= items.size())
+            items.resize(size_t(id) + 1);
+
+        Item& item = items[id];
+        if (item.inserted)
+            remove(id);
+
+        item.inserted = true;
+        item.min = min;
+        item.max = max;
+        cellRange(min, max, item.x0, item.y0, item.x1, item.y1);
+        link(id);
+        count++;
+    }
+
+    //Igual que quitar y volver a poner, pero si sigue en las mismas celdas no toca la rejilla
+    void update(uint32_t id, glm::vec2 min, glm::vec2 max){
+        if (!contains(id)){
+            insert(id, min, max);
+            return;
+        }
+
+        Item& item = items[id];
+        item.min = min;
+        item.max = max;
+
+        int32_t x0, y0, x1, y1;
+        cellRange(min, max, x0, y0, x1, y1);
+        if (x0 == item.x0 && y0 == item.y0 && x1 == item.x1 && y1 == item.y1)
+            return;
+
+        unlink(id);
+        item.x0 = x0;
+        item.y0 = y0;
+        item.x1 = x1;
+        item.y1 = y1;
+        link(id);
+    }
+
+    bool remove(uint32_t id){
+        if (!contains(id))
+            return false;
+
+        unlink(id);
+        items[id].inserted = false;
+        count--;
+        return true;
+    }
+
+    bool contains(uint32_t id) const{
+        return id < items.size() && items[id].inserted;
+    }
+
+    void clear(){
+        items.clear();
+        cells.clear();
+        cellLists.clear();
+        freeLists.clear();
+        large.clear();
+        count = 0;
+        hasBounds = false;
+        boundsDirty = false;
+    }
+
+    size_t size() const { return count; }
+    float getCellSize() const { return cellSize; }
+
+    glm::vec2 getMin(uint32_t id) const { return items[id].min; }
+    glm::vec2 getMax(uint32_t id) const { return items[id].max; }
+
+    //Llama a visit(id) una vez por cada elemento cuya caja toca el rectangulo
+    template<typename Visitor>
+    void forEachInRect(glm::vec2 min, glm::vec2 max, Visitor&& visit) const{
+        uint32_t stamp = nextStamp();
+
+        for (uint32_t id : large){
+            if (overlaps(items[id], min, max))
+                visit(id);
+        }
+
+        int32_t x0, y0, x1, y1;
+        cellRange(min, max, x0, y0, x1, y1);
+        if (!clampToBounds(x0, y0, x1, y1))
+            return;
+
+        for (int32_t y = y0; y <= y1; y++){
+            for (int32_t x = x0; x <= x1; x++){
+                HashMap<uint64_t, uint32_t>::const_iterator cell = cells.find(cellKey(x, y));
+                if (cell == cells.end())
+                    continue;
+
+                for (uint32_t id : cellLists[cell->second]){
+                    const Item& item = items[id];
+                    if (item.stamp == stamp)
+                        continue;
+
+                    item.stamp = stamp;
+                    if (overlaps(item, min, max))
+                        visit(id);
+                }
+            }
+        }
+    }
+
+    //Los elementos cuya caja contiene el punto
+    template<typename Visitor>
+    void forEachAtPoint(glm::vec2 point, Visitor&& visit) const{
+        forEachInRect(point, point, visit);
+    }
+
+    //Los k elementos mas cercanos al punto (distancia a su caja, 0 si el punto esta dentro), del mas cercano al mas lejano
+    //ids y distances tienen que tener sitio para k, devuelve cuantos ha encontrado
+    //Recorre anillos de celdas alrededor del punto y para en cuanto ningun elemento sin ver puede estar mas cerca
+    size_t nearest(glm::vec2 point, size_t k, uint32_t* ids, float* distances) const{
+        if (k == 0 || count == 0)
+            return 0;
+
+        uint32_t stamp = nextStamp();
+        size_t found = 0;
+
+        //Inserta en orden, si ya hay k se queda fuera el mas lejano
+        auto consider = [&](uint32_t id){
+            float distance = distanceTo(items[id], point);
+            if (found == k && distance >= distances[k - 1])
+                return;
+
+            size_t position = found < k ? found++ : k - 1;
+            while (position > 0 && distances[position - 1] > distance){
+                ids[position] = ids[position - 1];
+                distances[position] = distances[position - 1];
+                position--;
+            }
+            ids[position] = id;
+            distances[position] = distance;
+        };
+
+        for (uint32_t id : large)
+            consider(id);
+
+        refreshBounds();
+        if (!hasBounds)
+            return found;
+
+        //Cuando ya se han visto todos los de las celdas no hace falta seguir, aunque haya menos de k
+        size_t inCells = count - large.size();
+        size_t seen = 0;
+
+        int32_t centerX = cellCoordinate(point.x);
+        int32_t centerY = cellCoordinate(point.y);
+
+        //Los anillos que no llegan a ninguna celda usada estan vacios, se empieza en el primero que llega
+        int32_t firstRing = std::max(std::max(minCellX - centerX, centerX - maxCellX), std::max(minCellY - centerY, centerY - maxCellY));
+
+        for (int32_t ring = std::max(firstRing, 0);; ring++){
+            int32_t x0 = centerX - ring, x1 = centerX + ring;
+            int32_t y0 = centerY - ring, y1 = centerY + ring;
+
+            auto visitCell = [&](int32_t x, int32_t y){
+                HashMap<uint64_t, uint32_t>::const_iterator cell = cells.find(cellKey(x, y));
+                if (cell == cells.end())
+                    return;
+
+                for (uint32_t id : cellLists[cell->second]){
+                    if (items[id].stamp == stamp)
+                        continue;
+
+                    items[id].stamp = stamp;
+                    seen++;
+                    consider(id);
+                }
+            };
+
+            //Solo el borde del anillo y solo la parte que cae dentro de las celdas usadas
+            int32_t fromX = std::max(x0, minCellX), toX = std::min(x1, maxCellX);
+            int32_t fromY = std::max(y0, minCellY), toY = std::min(y1, maxCellY);
+            for (int32_t y = fromY; y <= toY; y++){
+                if (y == y0 || y == y1){
+                    for (int32_t x = fromX; x <= toX; x++)
+                        visitCell(x, y);
+                }else{
+                    if (x0 >= minCellX && x0 <= maxCellX)
+                        visitCell(x0, y);
+                    if (x1 >= minCellX && x1 <= maxCellX)
+                        visitCell(x1, y);
+                }
+            }
+
+            //Lo que no se ha visto esta en anillos mas lejanos, a ring celdas enteras como poco
+            if (found == k && distances[k - 1] <= float(ring) * cellSize)
+                return found;
+
+            if (seen == inCells)
+                return found;
+
+            //El anillo ya cubre todas las celdas que tienen algo
+            if (x0 <= minCellX && x1 >= maxCellX && y0 <= minCellY && y1 >= maxCellY)
+                return found;
+        }
+    }
+
+private:
+    struct Item{
+        glm::vec2 min, max;
+        //Celdas que toca, incluidas las dos esquinas
+        int32_t x0, y0, x1, y1;
+        //Posicion en large, o UINT32_MAX si esta en las celdas
+        uint32_t largeIndex = UINT32_MAX;
+        mutable uint32_t stamp = 0;
+        bool inserted = false;
+    };
+
+    //Mas celdas que esto y el elemento va a la lista de grandes
+    static const int64_t maxCellsPerItem = 64;
+
+    float cellSize;
+    float inverseCellSize;
+
+    std::vector<Item> items;
+    size_t count = 0;
+
+    //Celda -> su lista en cellLists. Las listas vacias se guardan en freeLists para no perder su memoria
+    HashMap<uint64_t, uint32_t> cells;
+    std::vector<std::vector<uint32_t>> cellLists;
+    std::vector<uint32_t> freeLists;
+    std::vector<uint32_t> large;
+
+    //Caja de las celdas que tienen algo. Limita las consultas y el anillo de nearest
+    //Al poner un elemento solo crece; al vaciarse una celda del borde se marca y se recalcula en la siguiente consulta,
+    //si no un elemento que se aparta lejos una vez dejaria todas las consultas recorriendo esa zona
+    mutable bool hasBounds = false;
+    mutable bool boundsDirty = false;
+    mutable int32_t minCellX = 0, minCellY = 0, maxCellX = 0, maxCellY = 0;
+
+    mutable uint32_t queryStamp;
+
+    uint32_t nextStamp() const{
+        //Al dar la vuelta hay que borrar las marcas viejas, si no alguna podria coincidir
+        if (++queryStamp == 0){
+            for (const Item& item : items)
+                item.stamp = 0;
+            queryStamp = 1;
+        }
+        return queryStamp;
+    }
+
+    int32_t cellCoordinate(float value) const{
+        float cell = std::floor(value * inverseCellSize);
+        return int32_t(std::max(-1e9f, std::min(1e9f, cell)));
+    }
+
+    void cellRange(glm::vec2 min, glm::vec2 max, int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) const{
+        x0 = cellCoordinate(min.x);
+        y0 = cellCoordinate(min.y);
+        x1 = cellCoordinate(max.x);
+        y1 = cellCoordinate(max.y);
+    }
+
+    static uint64_t cellKey(int32_t x, int32_t y){
+        return uint64_t(uint32_t(x)) << 32 | uint32_t(y);
+    }
+
+    static bool overlaps(const Item& item, glm::vec2 min, glm::vec2 max){
+        return item.max.x >= min.x && item.min.x <= max.x && item.max.y >= min.y && item.min.y <= max.y;
+    }
+
+    static float distanceTo(const Item& item, glm::vec2 point){
+        float dx = std::max(std::max(item.min.x - point.x, point.x - item.max.x), 0.0f);
+        float dy = std::max(std::max(item.min.y - point.y, point.y - item.max.y), 0.0f);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    //Recorre todas las celdas, solo pasa despues de vaciarse alguna del borde
+    void refreshBounds() const{
+        if (!boundsDirty)
+            return;
+
+        boundsDirty = false;
+        hasBounds = false;
+        for (const std::pair<uint64_t, uint32_t>& cell : cells){
+            int32_t x = int32_t(uint32_t(cell.first >> 32));
+            int32_t y = int32_t(uint32_t(cell.first));
+            if (!hasBounds){
+                minCellX = maxCellX = x;
+                minCellY = maxCellY = y;
+                hasBounds = true;
+            }else{
+                minCellX = std::min(minCellX, x);
+                minCellY = std::min(minCellY, y);
+                maxCellX = std::max(maxCellX, x);
+                maxCellY = std::max(maxCellY, y);
+            }
+        }
+    }
+
+    //Recorta el rango a las celdas usadas, false si no queda ninguna
+    bool clampToBounds(int32_t& x0, int32_t& y0, int32_t& x1, int32_t& y1) const{
+        refreshBounds();
+        if (!hasBounds)
+            return false;
+
+        x0 = std::max(x0, minCellX);
+        y0 = std::max(y0, minCellY);
+        x1 = std::min(x1, maxCellX);
+        y1 = std::min(y1, maxCellY);
+        return x0 <= x1 && y0 <= y1;
+    }
+
+    void link(uint32_t id){
+        Item& item = items[id];
+
+        if (int64_t(item.x1 - item.x0 + 1) * int64_t(item.y1 - item.y0 + 1) > maxCellsPerItem){
+            item.largeIndex = uint32_t(large.size());
+            large.push_back(id);
+            return;
+        }
+
+        if (!hasBounds){
+            minCellX = item.x0;
+            minCellY = item.y0;
+            maxCellX = item.x1;
+            maxCellY = item.y1;
+            hasBounds = true;
+        }else{
+            minCellX = std::min(minCellX, item.x0);
+            minCellY = std::min(minCellY, item.y0);
+            maxCellX = std::max(maxCellX, item.x1);
+            maxCellY = std::max(maxCellY, item.y1);
+        }
+
+        for (int32_t y = item.y0; y <= item.y1; y++){
+            for (int32_t x = item.x0; x <= item.x1; x++){
+                uint32_t list;
+                if (freeLists.empty()){
+                    list = uint32_t(cellLists.size());
+                }else{
+                    list = freeLists.back();
+                }
+
+                std::pair<HashMap<uint64_t, uint32_t>::iterator, bool> inserted = cells.insert(cellKey(x, y), list);
+                if (inserted.second){
+                    if (freeLists.empty())
+                        cellLists.emplace_back();
+                    else
+                        freeLists.pop_back();
+                }
+
+                cellLists[inserted.first->second].push_back(id);
+            }
+        }
+    }
+
+    void unlink(uint32_t id){
+        Item& item = items[id];
+
+        if (item.largeIndex != UINT32_MAX){
+            //El ultimo grande ocupa el hueco
+            uint32_t last = large.back();
+            large[item.largeIndex] = last;
+            items[last].largeIndex = item.largeIndex;
+            large.pop_back();
+            item.largeIndex = UINT32_MAX;
+            return;
+        }
+
+        for (int32_t y = item.y0; y <= item.y1; y++){
+            for (int32_t x = item.x0; x <= item.x1; x++){
+                HashMap<uint64_t, uint32_t>::iterator cell = cells.find(cellKey(x, y));
+                if (cell == cells.end())
+                    continue;
+
+                std::vector<uint32_t>& list = cellLists[cell->second];
+                std::vector<uint32_t>::iterator found = std::find(list.begin(), list.end(), id);
+                if (found != list.end()){
+                    *found = list.back();
+                    list.pop_back();
+                }
+
+                if (list.empty()){
+                    freeLists.push_back(cell->second);
+                    cells.erase(cell);
+                    if (x == minCellX || x == maxCellX || y == minCellY || y == maxCellY)
+                        boundsDirty = true;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef PIECE
 #define PIECE
 
-enum COLOR{
+enum COLOR : unsigned char{
     empty, 
     red,
     magenta,
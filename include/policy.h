@@ -0,0 +1,39 @@
+#ifndef POLICY
+#define POLICY
+
+#include "include/random.h"
+#include "include/simulation.h"
+
+#include <string>
+
+//Decide que accion hace el jugador en cada tick de una simulacion
+class IPolicy{
+public:
+    virtual ~IPolicy() = default;
+    virtual INPUT nextInput(const Simulation& simulation) = 0;
+};
+
+//Pulsa teclas al azar
+class RandomPolicy : public IPolicy{
+public:
+    RandomPolicy(uint64_t seed): random(seed){};
+
+    INPUT nextInput(const Simulation& simulation) override;
+
+private:
+    Random random;
+};
+
+//Repite en bucle un guion de acciones: L izquierda, R derecha, U rotar, D bajar, H caer, . nada
+class ScriptedPolicy : public IPolicy{
+public:
+    ScriptedPolicy(std::string script): script(script), index(0){};
+
+    INPUT nextInput(const Simulation& simulation) override;
+
+private:
+    std::string script;
+    size_t index;
+};
+
+#endif 
@@ -0,0 +1,26 @@
+#ifndef RANDOM
+#define RANDOM
+
+#include <cstdint>
+
+//Generador pseudoaleatorio pequeño (splitmix64), con la misma semilla da siempre la misma secuencia
+class Random{
+public:
+    Random(uint64_t seed = 0): state(seed){};
+
+    uint64_t next(){
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    //Entero en el rango [min, max]
+    int range(int min, int max){
+        return min + int(next() % uint64_t(max - min + 1));
+    }
+
+    uint64_t state;
+};
+
+#endif 
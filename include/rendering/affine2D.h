@@ -0,0 +1,61 @@
+#ifndef AFFINE_2D
+#define AFFINE_2D
+
+#include "include/glm/ext/vector_float2.hpp"
+
+#include <type_traits>
+
+//Transformacion afin en 2D: x' = a*x + c*y + tx, y' = b*x + d*y + ty
+//Son 6 floats seguidos en el mismo orden que un mat3x2 de GLSL (columnas (a,b), (c,d) y (tx,ty)), se sube tal cual a la GPU
+struct Affine2D{
+   float a, b;
+   float c, d;
+   float tx, ty;
+
+   static Affine2D identity(){ return Affine2D{ 1, 0, 0, 1, 0, 0 }; }
+
+   static Affine2D translation(glm::vec2 offset){ return Affine2D{ 1, 0, 0, 1, offset.x, offset.y }; }
+   static Affine2D scale(glm::vec2 factor){ return Affine2D{ factor.x, 0, 0, factor.y, 0, 0 }; }
+   //Con el seno y el coseno ya calculados
+   static Affine2D rotation(float sine, float cosine){ return Affine2D{ cosine, sine, -sine, cosine, 0, 0 }; }
+
+   glm::vec2 transformPoint(glm::vec2 point) const{
+      return glm::vec2(a * point.x + c * point.y + tx, b * point.x + d * point.y + ty);
+   }
+
+   //Sin la traslacion, para direcciones y tamaños
+   glm::vec2 transformVector(glm::vec2 vector) const{
+      return glm::vec2(a * vector.x + c * vector.y, b * vector.x + d * vector.y);
+   }
+
+   //(this * other) aplica primero other y despues this
+   Affine2D operator*(const Affine2D& other) const{
+      return Affine2D{
+         a * other.a + c * other.b,
+         b * other.a + d * other.b,
+         a * other.c + c * other.d,
+         b * other.c + d * other.d,
+         a * other.tx + c * other.ty + tx,
+         b * other.tx + d * other.ty + ty
+      };
+   }
+
+   float determinant() const{ return a * d - b * c; }
+
+   //Si el determinante es 0 (por ejemplo escala 0) no hay inversa y salen infinitos
+   Affine2D inverse() const{
+      float inverseDeterminant = 1.0f / determinant();
+
+      float ia = d * inverseDeterminant;
+      float ib = -b * inverseDeterminant;
+      float ic = -c * inverseDeterminant;
+      float id = a * inverseDeterminant;
+
+      return Affine2D{ ia, ib, ic, id, -(ia * tx + ic * ty), -(ib * tx + id * ty) };
+   }
+};
+
+static_assert(sizeof(Affine2D) == 6 * sizeof(float), "Affine2D tiene que ser 6 floats seguidos");
+static_assert(std::is_trivially_copyable<Affine2D>::value, "Affine2D se copia con memcpy");
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef BAKED_TEXTURE
+#define BAKED_TEXTURE
+
+#include "include/mappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Formato de las texturas horneadas por assetbaker (.tex), little endian:
+//  cabecera: BakedTextureHeader (32 bytes)
+//  datos:    los niveles de mipmap seguidos, del 0 al mipCount - 1, filas RGBA de 8 bits sin relleno
+//Las filas ya estan volteadas (la primera es la de abajo), como las espera glTexImage2D
+const uint32_t BAKED_TEXTURE_VERSION = 1;
+const int MAX_BAKED_MIPS = 16;
+
+struct BakedTextureHeader{
+   char magic[4];
+   uint32_t version;
+   uint32_t width;
+   uint32_t height;
+   uint32_t mipCount;
+   uint32_t reserved[3];
+};
+static_assert(sizeof(BakedTextureHeader) == 32, "La cabecera de las texturas horneadas ocupa 32 bytes");
+
+//Ruta del .tex que corresponde a una imagen: la misma con la extension cambiada
+std::string bakedTexturePath(const std::string& imagePath);
+
+//Si el .tex se ha horneado despues de la ultima vez que se guardo la imagen (o la imagen ya no esta)
+//Un .tex mas viejo que la imagen tiene los pixeles de antes de editarla
+bool bakedTextureIsCurrent(const std::string& imagePath, const std::string& bakedPath);
+
+//Hornea una textura RGBA (ya volteada), si withMips tambien calcula la cadena de mipmaps (media de 2x2)
+std::vector<uint8_t> bakeTexture(const uint8_t* pixels, uint32_t width, uint32_t height, bool withMips);
+//Lo mismo pero escrito en un archivo
+bool writeBakedTexture(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, bool withMips);
+
+//Textura horneada, los niveles apuntan directamente al archivo proyectado o a la memoria que se le pasa
+class BakedTexture{
+public:
+   BakedTexture(): header(nullptr){}
+
+   //Devuelve false si no existe o no es valida (cabecera, version o tamaño)
+   bool load(const std::string& path);
+   //Desde memoria que ya esta cargada (un asset del pack), no la copia y tiene que seguir viva
+   bool parse(const uint8_t* data, size_t size);
+
+   uint32_t width() const { return header->width; }
+   uint32_t height() const { return header->height; }
+   uint32_t mipCount() const { return header->mipCount; }
+
+   uint32_t levelWidth(uint32_t level) const;
+   uint32_t levelHeight(uint32_t level) const;
+   const uint8_t* levelData(uint32_t level) const { return levels[level]; }
+
+private:
+   MappedFile file;
+   const BakedTextureHeader* header;
+   const uint8_t* levels[MAX_BAKED_MIPS];
+};
+
+#endif
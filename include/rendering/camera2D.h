@@ -0,0 +1,61 @@
+#ifndef CAMERA_2D
+#define CAMERA_2D
+
+#include "include/glm/ext/vector_float2.hpp"
+#include "include/rendering/affine2D.h"
+
+#include <cmath>
+#include <cstdint>
+
+//Que parte del mundo (en pixeles) se ve en la ventana
+//position es el punto del mundo que queda en el centro de la ventana, con zoom 2 todo se ve el doble de grande
+//La rotacion es en grados, como la de los sprites: girar la camara gira el mundo al reves en la pantalla
+class Camera2D{
+public:
+   Camera2D(): position(0, 0), zoom(1), rotation(0), viewport(0, 0), revision(1), followsViewport(true){}
+
+   //Hasta que se llama a setPosition la camara esta en el centro de la ventana y lo sigue si cambia de tamaño,
+   //asi sin tocarla (0, 0) siempre es la esquina de abajo a la izquierda
+   void setPosition(glm::vec2 newPosition);
+   //Vuelve a la posicion por defecto
+   void centerOnViewport();
+   //Tiene que ser mayor que 0
+   void setZoom(float newZoom);
+   void setRotation(float newRotation);
+   //Tamaño de la ventana en pixeles, lo pone el engine
+   void setViewport(glm::vec2 size);
+
+   glm::vec2 getPosition() const { return position; }
+   float getZoom() const { return zoom; }
+   float getRotation() const { return rotation; }
+   glm::vec2 getViewport() const { return viewport; }
+
+   //Del mundo a pixeles de la ventana (0, 0 abajo a la izquierda) y al reves, para saber que hay debajo del raton
+   Affine2D worldToScreen() const;
+   Affine2D screenToWorld() const { return worldToScreen().inverse(); }
+
+   //Caja alineada con los ejes que contiene todo lo que se ve, con rotacion es mas grande que la ventana
+   void visibleBounds(glm::vec2& min, glm::vec2& max) const;
+
+   //Sube cada vez que cambia algo, para no volver a subir la proyeccion si no ha cambiado
+   uint32_t getRevision() const { return revision; }
+
+private:
+   glm::vec2 position;
+   float zoom;
+   float rotation;
+   glm::vec2 viewport;
+   uint32_t revision;
+   bool followsViewport;
+};
+
+//Si el quad de un sprite (de -0.5 a 0.5 transformado por su matriz) toca la caja
+inline bool quadInRect(const Affine2D& model, glm::vec2 min, glm::vec2 max){
+   //Mitad del tamaño de la caja del quad: la suma de los ejes en valor absoluto
+   float halfWidth = (std::fabs(model.a) + std::fabs(model.c)) * 0.5f;
+   float halfHeight = (std::fabs(model.b) + std::fabs(model.d)) * 0.5f;
+
+   return model.tx + halfWidth >= min.x && model.tx - halfWidth <= max.x && model.ty + halfHeight >= min.y && model.ty - halfHeight <= max.y;
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef GLYPH_TABLE
+#define GLYPH_TABLE
+
+#include <array>
+
+//Disposicion de la fuente bitmap: 16 x 8 celdas, la fila 0 es la de abajo de la textura
+const int FONT_COLUMNS = 16;
+const int FONT_ROWS = 8;
+
+struct Glyph{
+   bool valid;
+   //Celda del atlas
+   unsigned char cellX, cellY;
+   //Avance hasta el siguiente caracter, en alturas de letra
+   float advance;
+   //Rectangulo de la celda en coordenadas de textura (abajo izquierda, arriba derecha)
+   float u0, v0, u1, v1;
+};
+
+constexpr Glyph makeGlyph(int cellX, int cellY){
+   return Glyph{ true, (unsigned char)cellX, (unsigned char)cellY, 1.0f,
+                 float(cellX) / FONT_COLUMNS, float(cellY) / FONT_ROWS,
+                 float(cellX + 1) / FONT_COLUMNS, float(cellY + 1) / FONT_ROWS };
+}
+
+//Tabla de los 128 caracteres ASCII, los que no estan en la fuente quedan con valid = false
+constexpr std::array<Glyph, 128> makeGlyphTable(){
+   std::array<Glyph, 128> table = {};
+
+   table[' '] = makeGlyph(15, 6);
+
+   //'1' a '9' en la fila 4, el '0' va aparte al final de la fila 5
+   table['0'] = makeGlyph(15, 5);
+   for (int i = 0; i < 9; i++)
+      table['1' + i] = makeGlyph(i, 4);
+
+   //'A' a 'P' llenan la fila 3, 'Q' a 'Z' empiezan la fila 2
+   for (int i = 0; i < 26; i++)
+      table['A' + i] = makeGlyph(i % FONT_COLUMNS, 3 - i / FONT_COLUMNS);
+
+   return table;
+}
+
+constexpr std::array<Glyph, 128> GLYPHS = makeGlyphTable();
+
+//Un solo acceso al array, los caracteres fuera de ASCII (char negativo) no son validos
+inline const Glyph* findGlyph(char c){
+   unsigned char index = (unsigned char)c;
+   if (index >= GLYPHS.size() || !GLYPHS[index].valid)
+      return nullptr;
+
+   return &GLYPHS[index];
+}
+
+static_assert(GLYPHS['Z'].cellX == 9 && GLYPHS['Z'].cellY == 2, "La tabla de glifos no coincide con la fuente");
+static_assert(GLYPHS['9'].cellX == 8 && GLYPHS['9'].cellY == 4, "La tabla de glifos no coincide con la fuente");
+static_assert(!GLYPHS['a'].valid, "La fuente no tiene minusculas");
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PROGRAM_CACHE
+#define PROGRAM_CACHE
+
+#include <cstdint>
+#include <string_view>
+
+//Cache en disco de los shaders ya enlazados (glGetProgramBinary / glProgramBinary)
+//Se guarda en shaderCache/<driver>/<fuente>.bin al lado del ejecutable. <driver> es el hash del vendor, renderer y version,
+//al cambiar de driver se borra la cache del anterior. Si el driver rechaza un binario se borra y se vuelve a compilar
+//Necesita GL 4.1 o ARB_get_program_binary, glad solo carga hasta 3.3 asi que las funciones se piden a GLFW
+class ProgramCache{
+public:
+   //Despues de cargar GLAD, sin llamarlo (o sin soporte) la cache no hace nada
+   static void init();
+   static bool enabled();
+
+   //Clave de un programa a partir de su codigo, ya incluye el driver
+   static uint64_t key(std::string_view vertexSource, std::string_view fragmentSource);
+
+   //Devuelve el programa enlazado o 0 si no esta en la cache o ya no vale
+   static unsigned int load(uint64_t key);
+   //Guarda un programa enlazado, tiene que tener GL_PROGRAM_BINARY_RETRIEVABLE_HINT (prepareForStore) antes de enlazar
+   static void store(uint64_t key, unsigned int program);
+   static void prepareForStore(unsigned int program);
+
+   static unsigned int hits();
+   static unsigned int misses();
+};
+
+#endif
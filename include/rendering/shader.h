@@ -7,14 +7,37 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "include/myLibs/hashMap.h"
+
+//Punto de enlace del uniform buffer con la proyeccion, los shaders lo leen en el bloque "Projection"
+const unsigned int PROJECTION_BINDING = 0;
 
 class Shader
 {
 public:
-   // the program ID
+   // the program ID, cambia al recargar
    unsigned int ID;
+   // sube cada vez que reload cambia el programa, para volver a pedir las posiciones de los uniforms
+   unsigned int generation;
    // constructor reads and builds the shader
-   Shader(const char* vertexPath, const char* fragmentPath);
+   // defines son las de la permutacion, "NOMBRE" o "NOMBRE=VALOR" separadas por espacios (ver preprocessShader)
+   Shader(const char* vertexName, const char* fragmentName, std::string_view defines = "");
+
+   Shader(const Shader&) = delete;
+   Shader& operator=(const Shader&) = delete;
+
+   // la permutacion compartida de ese par de shaders, se compila la primera vez que se pide
+   // el mismo conjunto de defines en otro orden es la misma permutacion
+   static Shader& get(const char* vertexName, const char* fragmentName, std::string_view defines = "");
+   // recompila todas las permutaciones que usan ese asset (tambien si lo incluyen), false si ninguna lo usa
+   static bool reloadUsing(std::string_view name);
+   // borra todas las permutaciones, las referencias que devolvio get dejan de valer
+   static void clearPermutations();
+   static size_t permutationCount();
    // use/activate the shader
 
    void use();
@@ -22,5 +45,25 @@ public:
    void setBool(const std::string &name, bool value) const;
    void setInt(const std::string &name, int value) const;
    void setFloat(const std::string &name, float value) const;
+   // enlaza un uniform block del shader a un punto de enlace, no hace nada si el shader no lo tiene
+   void bindUniformBlock(const char* blockName, unsigned int binding);
+
+   // recompila desde los archivos sueltos, si no compila se queda con el programa anterior y devuelve false
+   bool reload();
+   bool usesAsset(std::string_view name) const;
+
+private:
+   std::string vertexName;
+   std::string fragmentName;
+   std::string defines;
+   // los archivos de la ultima compilacion, con los includes
+   std::vector<std::string> assets;
+   std::vector<std::pair<std::string, unsigned int>> uniformBlocks;
+
+   // compila desde el pack (o los archivos sueltos con fromFile), 0 si algo falla
+   unsigned int build(bool fromFile);
+
+   // clave: los nombres de los dos shaders y las defines normalizadas
+   static HashMap<std::string, Shader*> permutations;
 };
 #endif
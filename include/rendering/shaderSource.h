@@ -0,0 +1,33 @@
+#ifndef SHADER_SOURCE
+#define SHADER_SOURCE
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Codigo GLSL ya preprocesado, listo para glShaderSource
+struct ShaderSource{
+   std::string code;
+   //Assets que se han leido, el primero es el shader. La posicion es el numero de fuente de los #line,
+   //asi los errores del driver ("1(12)") dicen el archivo y la linea
+   std::vector<std::string> files;
+};
+
+//Deja las defines de una permutacion en una forma unica: separadas por un espacio, ordenadas y sin repetir
+//Si un nombre sale varias veces se queda la ultima: "B A=2  B A=3" -> "A=3 B"
+std::string normalizeShaderDefines(std::string_view defines);
+
+//Lee el shader y sustituye los #include "archivo" (relativos a la carpeta del que los incluye, cada archivo una sola vez)
+//Los #include se resuelven siempre, aunque esten dentro de un #ifdef, pero no dentro de un comentario /* */
+//Las defines ("NOMBRE" o "NOMBRE=VALOR" separadas por espacios) se meten justo despues de #version, NOMBRE solo vale 1
+//Con fromFile se leen los archivos sueltos en vez del pack, para recargar. Devuelve false si falta algun archivo
+bool preprocessShader(const std::string& name, std::string_view defines, bool fromFile, ShaderSource& source);
+
+//Lee un archivo por nombre, false si no existe
+typedef std::function<bool(const std::string& name, std::string& contents)> ShaderReader;
+
+//Lo mismo leyendo los archivos con read, para preprocesar sin pasar por los assets
+bool preprocessShaderWith(const std::string& name, std::string_view defines, const ShaderReader& read, ShaderSource& source);
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef SPRITE_RENDERER
+#define SPRITE_RENDERER
+
+#include "include/rendering/shader.h"
+#include "include/rendering/spriteStore.h"
+#include "include/myLibs/hashMap.h"
+#include "include/rendering/affine2D.h"
+#include "include/rendering/camera2D.h"
+
+#include <cstdint>
+#include <vector>
+
+//Datos de cada sprite que se mandan a la GPU, uno por instancia del quad
+//La matriz del sprite en pixeles, la proyeccion esta en el uniform buffer del engine
+struct SpriteInstance{
+   Affine2D model;
+};
+static_assert(sizeof(SpriteInstance) == 6 * sizeof(float), "Los atributos por instancia esperan 6 floats seguidos");
+
+//Dibuja todo un SpriteStore con un solo quad y una llamada instanciada por cada capa y textura
+//Las instancias se escriben recorriendo los arrays del SpriteStore en orden (ordenacion por cuentas en dos pasadas)
+class SpriteRenderer{
+public:
+   SpriteRenderer();
+   ~SpriteRenderer();
+
+   SpriteRenderer(const SpriteRenderer&) = delete;
+   SpriteRenderer& operator=(const SpriteRenderer&) = delete;
+
+   //Las matrices de los sprites tienen que estar al dia (SpriteStore::updateModels)
+   //Solo se mandan los sprites que tocan la caja visible (en pixeles del mundo, ver Camera2D::visibleBounds)
+   void render(const SpriteStore& sprites, glm::vec2 viewMin, glm::vec2 viewMax);
+
+   Shader& getShader(){ return shader; }
+
+   //Llamadas a glDraw y sprites dibujados y descartados del ultimo render
+   int drawCalls;
+   uint32_t drawnSprites;
+   uint32_t culledSprites;
+
+private:
+   //Sprites con la misma capa y textura, se dibujan juntos
+   struct Batch{
+      uint64_t key;
+      unsigned int texture;
+      uint32_t count;
+      uint32_t offset;
+      uint32_t previousIndex;
+   };
+
+   //Grupo de los sprites que estan fuera de la vista
+   static const uint32_t culled = UINT32_MAX;
+
+   Shader& shader;
+   unsigned int VAO, VBO, EBO, instanceVBO;
+   size_t instanceCapacity;
+
+   //Se reutilizan de un frame a otro para no reservar memoria
+   HashMap<uint64_t, uint32_t> batchIndex;
+   std::vector<Batch> batches;
+   std::vector<uint32_t> remap;
+   std::vector<uint32_t> spriteBatch;
+   std::vector<SpriteInstance> instances;
+
+   void setInstanceOffset(uint32_t offset);
+};
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef SPRITE_STORE
+#define SPRITE_STORE
+
+#include "include/glm/ext/vector_float2.hpp"
+#include "include/rendering/affine2D.h"
+#include "include/myLibs/slotMap.h"
+#include "include/myLibs/spatialHash.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+typedef SlotHandle SpriteHandle;
+
+//Todos los sprites en arrays separados por campo (posiciones, escalas, rotaciones, capas y texturas)
+//Cada sprite son ~50 bytes y el renderizador recorre los arrays de principio a fin
+//La matriz de cada sprite (en pixeles) se guarda y solo se recalcula si ha cambiado su posicion, escala o rotacion
+//Los handles funcionan igual que en SlotMap: borrar mueve el ultimo sprite al hueco y un handle viejo nunca apunta a otro sprite
+//Las funciones con un handle que ya no es valido no hacen nada
+//La caja de cada sprite esta ademas en un SpatialHash que se actualiza al moverlo, escalarlo o girarlo,
+//asi pick, queryRect y nearest solo miran los sprites que estan cerca y no todos
+class SpriteStore{
+public:
+    SpriteStore(): freeHead(noSlot){}
+
+    //La textura no es del SpriteStore, quien la crea la tiene que borrar
+    SpriteHandle add(unsigned int texture, float x, float y, float width, float heigth, uint8_t layer);
+    bool remove(SpriteHandle sprite);
+    bool contains(SpriteHandle sprite) const;
+
+    void setPosition(SpriteHandle sprite, float x, float y);
+    void setScale(SpriteHandle sprite, float width, float heigth);
+    //En grados
+    void setRotation(SpriteHandle sprite, float rotation);
+    void setTexture(SpriteHandle sprite, unsigned int texture);
+    //Las capas se dibujan de menor a mayor
+    void setLayer(SpriteHandle sprite, uint8_t layer);
+
+    glm::vec2 getPosition(SpriteHandle sprite) const;
+    glm::vec2 getScale(SpriteHandle sprite) const;
+    float getRotation(SpriteHandle sprite) const;
+    unsigned int getTexture(SpriteHandle sprite) const;
+
+    //Recalcula las matrices de los sprites que han cambiado desde la ultima llamada
+    void updateModels();
+
+    //Consultas en pixeles del mundo, sin reservar memoria: escriben como mucho capacity handles en results
+    //y devuelven cuantos sprites cumplen aunque no quepan todos
+    //Sprites que tienen el punto dentro (teniendo en cuenta su rotacion), los de la capa mas alta primero
+    size_t pick(glm::vec2 point, SpriteHandle* results, size_t capacity) const;
+    //Sprites cuya caja toca el rectangulo, sin ningun orden
+    size_t queryRect(glm::vec2 min, glm::vec2 max, SpriteHandle* results, size_t capacity) const;
+    //Los k sprites mas cercanos al punto (distancia a su caja), del mas cercano al mas lejano. results tiene sitio para k
+    size_t nearest(glm::vec2 point, size_t k, SpriteHandle* results) const;
+
+    void reserve(size_t capacity);
+    void clear();
+
+    size_t size() const { return textures.size(); }
+    bool empty() const { return textures.empty(); }
+
+    //Arrays para recorrer todos los sprites, el elemento i de cada uno es el mismo sprite
+    const glm::vec2* positionData() const { return positions.data(); }
+    const glm::vec2* scaleData() const { return scales.data(); }
+    const float* rotationData() const { return rotations.data(); }
+    const uint8_t* layerData() const { return layers.data(); }
+    const unsigned int* textureData() const { return textures.data(); }
+    //Solo estan al dia despues de updateModels
+    const Affine2D* modelData() const { return models.data(); }
+
+private:
+    static const uint32_t noSlot = UINT32_MAX;
+
+    //Si el slot esta libre denseIndex es el siguiente slot libre
+    struct Slot{
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    std::vector<glm::vec2> positions;
+    std::vector<glm::vec2> scales;
+    std::vector<float> rotations;
+    std::vector<uint8_t> layers;
+    std::vector<unsigned int> textures;
+
+    std::vector<Affine2D> models;
+    std::vector<uint8_t> dirty;
+    //Sprites con dirty a 1, para no recorrer nada si no ha cambiado ninguno
+    size_t dirtyCount = 0;
+
+    std::vector<uint32_t> itemSlots;
+    std::vector<Slot> slots;
+    uint32_t freeHead;
+
+    //Los ids son los slots, que no cambian al borrar otros sprites
+    SpatialHash spatialIndex;
+    //Para nearest, solo crecen
+    mutable std::vector<uint32_t> nearestSlots;
+    mutable std::vector<float> nearestDistances;
+
+    //Devuelve noSlot si el handle no es valido
+    uint32_t denseIndex(SpriteHandle sprite) const;
+    void markDirty(uint32_t dense);
+    //Vuelve a poner la caja del sprite en el indice espacial
+    void updateBounds(uint32_t dense);
+};
+
+#endif
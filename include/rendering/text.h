@@ -2,33 +2,55 @@
 #define TEXT
 
 #include "include/rendering/shader.h"
+#include "include/rendering/glyphTable.h"
+#include "include/rendering/textureManager.h"
+#include "include/glm/ext/vector_float2.hpp"
 #include <stdio.h>
-#include <string>
-#include <vector>
+#include <string_view>
 
-struct Character{
-   unsigned int VAO;
-   unsigned int VBO;
-   unsigned int EBO;
-};
+//Caracteres maximos de un texto, se guardan dentro del propio Text sin reservar memoria
+const int MAX_TEXT_LENGTH = 32;
    
 class Text{
 public:
-   Text(std::string initialText,int startX , int startY,int startHeight ,unsigned int bitmapFont);
+   //Cada texto tiene su referencia a la fuente y la suelta al borrarse
+   Text(std::string_view initialText,int startX , int startY,int startHeight ,TextureManager& textures, TextureHandle bitmapFont);
    ~Text();
 
-   void setText(std::string newText);
+   //Devuelve false y deja el texto como estaba si es demasiado largo o tiene caracteres que no estan en la fuente
+   //Si el texto es el mismo solo cuesta un memcmp
+   bool setText(std::string_view newText);
+   bool setNumber(long long number);
+
+   std::string_view getText() const;
+   //Caja que ocupa el texto en pixeles de la ventana, vacia (min > max) si no tiene caracteres
+   void getBounds(glm::vec2& min, glm::vec2& max) const;
+
+   void render();
 
-   void render(float width, float height);
+   Shader& getShader(){ return shader; }
 
    int x, y;
    int heigth;
 private:
-   std::string text;
-   Shader shader;
+   char text[MAX_TEXT_LENGTH];
+   int length;
+
+   //Glifo de cada caracter, solo se recalcula cuando cambia el texto
+   const Glyph* glyphs[MAX_TEXT_LENGTH];
+
+   //Compartido por todos los textos
+   Shader& shader;
+   TextureManager& textures;
+   TextureHandle font;
    unsigned int texture;
+   int transformLoc, uvRectLoc;
+   unsigned int shaderGeneration;
+   void updateUniformLocations();
 
-   std::vector<Character> characters;
+   unsigned int VAO;
+   unsigned int VBO;
+   unsigned int EBO;
 };
 
 #endif 
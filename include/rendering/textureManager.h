@@ -0,0 +1,93 @@
+#ifndef TEXTURE_MANAGER
+#define TEXTURE_MANAGER
+
+#include "include/myLibs/hashMap.h"
+#include "include/myLibs/slotMap.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+enum TEXTURE_FORMAT{ textureRGBA, textureRGB };
+enum TEXTURE_FILTER{ filterNearest, filterLinear };
+
+//Como se crea una textura. Sin mipmaps solo se sube el nivel 0
+//Con filterNearest y sin mipmaps (lo de siempre) los pixeles se ven tal cual
+struct TextureOptions{
+   TEXTURE_FORMAT format = textureRGBA;
+   TEXTURE_FILTER filter = filterNearest;
+   bool mipmaps = false;
+
+   bool operator==(const TextureOptions& other) const { return format == other.format && filter == other.filter && mipmaps == other.mipmaps; }
+};
+
+//Referencia a una textura del TextureManager, deja de ser valida cuando se suelta la ultima referencia
+typedef SlotHandle TextureHandle;
+
+//Carga las texturas por nombre de asset y no repite ninguna: dos peticiones con el mismo nombre y opciones,
+//o con otro nombre pero los mismos pixeles, devuelven la misma textura con una referencia mas
+//Cada load o acquire se tiene que compensar con un release, con la ultima se borra la textura de la GPU
+class TextureManager{
+public:
+   TextureManager() = default;
+   ~TextureManager(){ clear(); }
+
+   TextureManager(const TextureManager&) = delete;
+   TextureManager& operator=(const TextureManager&) = delete;
+
+   //Devuelve un handle invalido si no se encuentra o no se puede leer la imagen
+   TextureHandle load(const std::string& name, TextureOptions options = TextureOptions());
+   void acquire(TextureHandle handle);
+   void release(TextureHandle handle);
+
+   bool contains(TextureHandle handle) const { return textures.contains(handle); }
+   //Handle de un id de OpenGL del manager, invalido si no es suyo
+   TextureHandle find(unsigned int glTexture) const;
+   //Id de OpenGL de la textura, 0 si el handle no es valido
+   unsigned int glTexture(TextureHandle handle) const;
+   uint32_t references(TextureHandle handle) const;
+
+   //Vuelve a leer la imagen del archivo suelto y la sube en los mismos ids, false si nadie la usa o no se puede leer
+   bool reload(std::string_view name);
+
+   //Con false cada nombre tiene su propia textura aunque otro tenga los mismos pixeles, para que recargar uno no cambie
+   //los demas. Solo afecta a las que se cargan despues
+   void setShareContent(bool share){ shareContent = share; }
+
+   //Borra todas las texturas aunque tengan referencias, lo hace el engine al parar
+   void clear();
+
+   size_t size() const { return textures.size(); }
+   //Memoria estimada en la GPU: lo que ocupan los pixeles (RGB cuenta como 4 bytes, como lo guardan los drivers) y los mipmaps
+   size_t residentBytes() const { return totalBytes; }
+   void printReport(FILE* file) const;
+
+private:
+   struct Texture{
+      std::string name;
+      TextureOptions options;
+      unsigned int texture;
+      uint32_t references;
+      uint64_t contentKey;
+      uint32_t width, height;
+      size_t bytes;
+      //Recargada del archivo suelto, para leer los mismos pixeles al comparar
+      bool fromFile;
+   };
+
+   SlotMap<Texture> textures;
+   //Nombre y opciones, y hash del contenido y opciones, a la textura
+   HashMap<std::string, TextureHandle> byName;
+   HashMap<uint64_t, TextureHandle> byContent;
+   //Id de OpenGL a la textura, los sprites guardan el id
+   HashMap<unsigned int, TextureHandle> byTexture;
+   size_t totalBytes = 0;
+   bool shareContent = true;
+
+   static std::string nameKey(const std::string& name, TextureOptions options);
+   void remove(TextureHandle handle);
+};
+
+#endif
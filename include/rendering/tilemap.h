@@ -0,0 +1,85 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include "include/glm/ext/vector_float2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//Lado de un chunk en tiles, cada chunk se sube y se dibuja de una vez
+const uint32_t TILEMAP_CHUNK_SIZE = 32;
+const uint32_t TILEMAP_CHUNK_TILES = TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE;
+//Tile que no se dibuja
+const uint16_t TILE_EMPTY = 0xFFFF;
+
+//Un tile de un chunk en la GPU: su posicion dentro del chunk
+struct TileInstance{
+   uint16_t x, y;
+};
+
+//Tiles seguidos con el mismo indice dentro de las instancias de un chunk, se dibujan con una llamada
+struct TileRange{
+   uint16_t tile;
+   uint32_t offset;
+   uint32_t count;
+};
+
+//Rejilla de indices de tile partida en chunks de TILEMAP_CHUNK_SIZE x TILEMAP_CHUNK_SIZE
+//Los tiles de cada chunk estan seguidos en memoria (2 bytes por tile) y cada chunk tiene una revision que sube
+//cuando cambia alguno de sus tiles, asi el renderizador solo rehace los chunks que han cambiado
+//El tile (0, 0) es el de abajo a la izquierda y origin es su esquina, en pixeles
+//La paleta dice la textura de cada indice, cambiarla no obliga a rehacer nada
+class Tilemap{
+public:
+   Tilemap(uint32_t width, uint32_t height, float tileSize, glm::vec2 origin);
+
+   uint32_t getWidth() const { return width; }
+   uint32_t getHeight() const { return height; }
+   float getTileSize() const { return tileSize; }
+   glm::vec2 getOrigin() const { return origin; }
+
+   //Fuera del mapa devuelve TILE_EMPTY y setTile no hace nada
+   uint16_t getTile(uint32_t x, uint32_t y) const;
+   void setTile(uint32_t x, uint32_t y, uint16_t tile);
+   void fill(uint16_t tile);
+
+   void setPalette(uint16_t tile, unsigned int texture);
+   //0 si el indice no tiene textura
+   unsigned int getPalette(uint16_t tile) const { return tile < palette.size() ? palette[tile] : 0; }
+
+   //Tile que hay en un punto en pixeles, false si esta fuera
+   bool tileAt(glm::vec2 point, uint32_t& x, uint32_t& y) const;
+
+   uint32_t chunksX() const { return chunkColumns; }
+   uint32_t chunksY() const { return chunkRows; }
+   uint32_t chunkCount() const { return chunkColumns * chunkRows; }
+   uint32_t chunkRevision(uint32_t chunk) const { return revisions[chunk]; }
+   //Esquina de abajo a la izquierda del chunk en pixeles
+   glm::vec2 chunkOrigin(uint32_t chunkX, uint32_t chunkY) const;
+
+   //Chunks que tocan el rectangulo (en pixeles), como rango [x0, x1) [y0, y1). false si no toca ninguno
+   //No recorre nada, cuesta lo mismo con mapas de cualquier tamaño
+   bool chunksInRect(glm::vec2 min, glm::vec2 max, uint32_t& x0, uint32_t& y0, uint32_t& x1, uint32_t& y1) const;
+
+   //Instancias del chunk ordenadas por indice de tile y un rango por indice, sin los tiles vacios
+   //Los vectores se reutilizan entre llamadas
+   void buildChunk(uint32_t chunk, std::vector<TileInstance>& instances, std::vector<TileRange>& ranges) const;
+
+private:
+   uint32_t width, height;
+   uint32_t chunkColumns, chunkRows;
+   float tileSize;
+   glm::vec2 origin;
+
+   std::vector<uint16_t> tiles;
+   std::vector<uint32_t> revisions;
+   std::vector<unsigned int> palette;
+
+   //Para ordenar un chunk sin reservar memoria cada vez
+   mutable std::vector<uint32_t> sortKeys;
+
+   size_t tileIndex(uint32_t x, uint32_t y) const;
+};
+
+#endif
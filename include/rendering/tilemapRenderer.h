@@ -0,0 +1,66 @@
+#ifndef TILEMAP_RENDERER
+#define TILEMAP_RENDERER
+
+#include "include/rendering/shader.h"
+#include "include/rendering/tilemap.h"
+#include "include/glm/ext/vector_float2.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//Dibuja Tilemaps: cada chunk tiene su buffer de instancias en la GPU y solo se rehace cuando cambia su revision
+//Solo se miran los chunks que tocan la vista, un chunk fuera de la vista no se rehace ni se dibuja
+//Una llamada instanciada por chunk y textura de la paleta
+class TilemapRenderer{
+public:
+   TilemapRenderer();
+   ~TilemapRenderer();
+
+   TilemapRenderer(const TilemapRenderer&) = delete;
+   TilemapRenderer& operator=(const TilemapRenderer&) = delete;
+
+   //Una vez por frame antes de dibujar los mapas, pone a 0 las estadisticas y el presupuesto
+   void beginFrame();
+   //La vista es el rectangulo visible en pixeles
+   void render(const Tilemap& map, glm::vec2 viewMin, glm::vec2 viewMax);
+   //Borra los buffers del mapa, antes de destruirlo
+   void forget(const Tilemap& map);
+
+   Shader& getShader(){ return shader; }
+
+   //Chunks que ya tenian buffer y cambian se rehacen como mucho estos por frame, el resto se dibuja
+   //un frame mas como estaba. Los que no tienen buffer siempre se hacen, si no habria huecos
+   uint32_t maxRebuildsPerFrame;
+
+   //Del ultimo frame, sumando todos los mapas
+   int drawCalls;
+   uint32_t visibleChunks;
+   uint32_t culledChunks;
+   uint32_t rebuiltChunks;
+
+private:
+   struct ChunkMesh{
+      unsigned int buffer;
+      uint32_t revision;
+      std::vector<TileRange> ranges;
+   };
+
+   Shader& shader;
+   unsigned int VAO, VBO, EBO;
+   int chunkOriginLoc, tileSizeLoc;
+   unsigned int shaderGeneration;
+
+   //Los buffers de cada mapa, hay pocos mapas
+   std::vector<std::pair<const Tilemap*, std::vector<ChunkMesh>>> maps;
+   uint32_t rebuildBudget;
+
+   //Se reutiliza para no reservar memoria
+   std::vector<TileInstance> instances;
+
+   std::vector<ChunkMesh>& meshesOf(const Tilemap& map);
+   void rebuild(const Tilemap& map, uint32_t chunk, ChunkMesh& mesh);
+   void updateUniformLocations();
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef TRANSFORM_KERNEL_H
+#define TRANSFORM_KERNEL_H
+
+#include "include/glm/ext/vector_float2.hpp"
+#include "include/rendering/affine2D.h"
+
+#include <cstddef>
+
+//Implementaciones de buildTransforms, kernelAuto usa la mejor que tenga el procesador
+enum TRANSFORM_KERNEL{ kernelAuto, kernelScalar, kernelSSE, kernelAVX };
+
+//Calcula las matrices de count sprites a partir de sus arrays de posicion, escala y rotacion (en grados)
+//Cada matriz es escala, despues rotacion y despues traslacion (columnas: eje x, eje y, traslacion)
+//Las versiones SSE y AVX hacen 4 y 8 sprites por iteracion, el seno y el coseno son el mismo polinomio en todas
+//Para angulos de mas de unos millones de grados se pierde precision, mas de 1e8 grados (o NaN) se recortan a +-1e8
+void buildTransforms(const glm::vec2* positions, const glm::vec2* scales, const float* rotations, Affine2D* out, size_t count, TRANSFORM_KERNEL kernel = kernelAuto);
+
+//Si el procesador (y el compilador) tienen esa implementacion
+bool transformKernelAvailable(TRANSFORM_KERNEL kernel);
+TRANSFORM_KERNEL bestTransformKernel();
+const char* transformKernelName(TRANSFORM_KERNEL kernel);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef REPLAY
+#define REPLAY
+
+#include "include/policy.h"
+#include "include/simulation.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Formato de las repeticiones:
+//  cabecera: "TRPL", version, ticks por segundo y semilla (varints)
+//  eventos:  varint((ticks desde el evento anterior << 3) | input)
+//  final:    evento con input REPLAY_END, seguido de los puntos y el hash del tablero para comprobar la reproduccion
+const uint32_t REPLAY_VERSION = 1;
+const int REPLAY_END = 7;
+
+//Guarda el input que recibe la simulacion en cada tick
+class ReplayRecorder{
+public:
+    ReplayRecorder(std::string path): path(path), lastTick(0), recording(false){};
+
+    void start(uint64_t seed);
+    void record(uint64_t tick, INPUT input);
+    bool finish(const Simulation& simulation);
+
+    bool isRecording(){ return recording; }
+
+private:
+    std::string path;
+    std::vector<uint8_t> data;
+    uint64_t lastTick;
+    bool recording;
+};
+
+//Reproduce una repeticion como si fuese el jugador
+class ReplayPlayer : public IPolicy{
+public:
+    ReplayPlayer(): seed(0), endTick(0), points(0), boardHash(0), position(0), nextTick(0), nextInputToPlay(inputNone){};
+
+    bool load(const std::string& path);
+    void rewind();
+
+    INPUT nextInput(const Simulation& simulation) override;
+
+    bool finished(const Simulation& simulation){ return simulation.state.ticks >= endTick; }
+    bool matches(const Simulation& simulation){ return simulation.state.points == points && simulation.state.board.hash() == boardHash; }
+
+    uint64_t seed;
+    uint64_t endTick;
+    int points;
+    uint64_t boardHash;
+
+private:
+    std::vector<uint8_t> data;
+    size_t eventsStart;
+    size_t position;
+
+    uint64_t nextTick;
+    INPUT nextInputToPlay;
+
+    void readEvent();
+};
+
+#endif 
@@ -0,0 +1,74 @@
+#ifndef SIMULATION
+#define SIMULATION
+
+#include "include/board.h"
+#include "include/movingPiece.h"
+#include "include/piece.h"
+#include "include/random.h"
+
+#include <cstdint>
+#include <type_traits>
+
+//Acciones que puede hacer el jugador en un tick
+enum INPUT{
+    inputNone,
+    inputLeft,
+    inputRight,
+    inputRotate,
+    inputSoftDrop,
+    inputHardDrop,
+};
+
+//Todo el estado de una partida en un bloque sin punteros, se puede copiar con memcpy
+struct GameState{
+    Board board;
+    MovingPiece movingPiece;
+    MovingPiece nextPiece;
+    Random random;
+
+    int points;
+    int piecesPlaced;
+    int linesCleared;
+    uint64_t ticks;
+    uint64_t seed;
+    bool isOver;
+
+    //Ticks que quedan para poder volver a mover o rotar, y los que lleva la pieza sin caer
+    int moveCooldown;
+    int rotateCooldown;
+    int fallTimer;
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay trivially copyable");
+
+//Reglas del tetris sin nada de renderizado, avanza a ticks fijos para que sea determinista
+class Simulation{
+public:
+    Simulation(uint64_t seed);
+
+    static const int tickRate = 60;
+
+    void tick(INPUT input);
+    void reset(uint64_t seed);
+
+    //Guardar y recuperar el estado es una copia de GameState
+    GameState save() const { return state; }
+    void restore(const GameState& snapshot){ state = snapshot; }
+
+    GameState state;
+
+    bool isValidMove(int newX, int newY, const MovingPiece& piece) const;
+
+private:
+    void movePiece();
+    void placePiece();
+    void deleteRow(int row);
+    void spawnPiece();
+};
+
+//Tiempos en ticks (a 60 ticks por segundo)
+const int FALL_TICKS = 15;
+const int MOVE_COOLDOWN_TICKS = 4;
+const int ROTATE_COOLDOWN_TICKS = 12;
+
+#endif 
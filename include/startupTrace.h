@@ -0,0 +1,46 @@
+#ifndef STARTUP_TRACE
+#define STARTUP_TRACE
+
+#include <cstdint>
+#include <string>
+
+//Mide cuanto tarda cada fase del arranque, desde main() hasta que se presenta el primer frame
+//Solo mide despues de enable (--startup-trace), si no cada fase es leer un bool
+//Al acabar escribe un informe en JSON con el tiempo total y, por fase, las veces que se ha entrado, el tiempo
+//total (ms) y el tiempo sin contar las fases de dentro (selfMs). Los selfMs mas otherMs suman totalMs
+class StartupTrace{
+public:
+   //Lo primero de main, los tiempos cuentan desde aqui
+   static void start();
+   //Escribe el informe en path al acabar ("-" es stdout)
+   static void enable(const std::string& path);
+   //Entre enable y finish
+   static bool running();
+   //Cierra la medida y escribe el informe, false si no se ha podido escribir
+   static bool finish();
+
+   static void record(const char* phase, uint64_t nanoseconds, uint64_t selfNanoseconds);
+};
+
+//Fase del arranque, mide desde que se crea hasta end() o hasta que se destruye
+//El nombre tiene que vivir todo el programa (un literal). Las fases que se repiten se suman
+class StartupPhase{
+public:
+   StartupPhase(const char* name);
+   ~StartupPhase(){ end(); }
+
+   StartupPhase(const StartupPhase&) = delete;
+   StartupPhase& operator=(const StartupPhase&) = delete;
+
+   //Para las fases que no son un bloque, como construir un objeto que tiene que seguir vivo
+   void end();
+
+private:
+   const char* name;
+   StartupPhase* parent;
+   uint64_t begin;
+   uint64_t children;
+   bool active;
+};
+
+#endif
@@ -0,0 +1,330 @@
+#include "include/allocTracker.h"
+
+#ifdef TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if !defined(NDEBUG) && defined(__GLIBC__)
+#include <execinfo.h>
+#endif
+
+//Aqui no se puede reservar memoria: todo son arrays fijos y atomicos, y se escribe con fprintf
+
+struct Counters{
+   std::atomic<uint64_t> allocations;
+   std::atomic<uint64_t> frees;
+   std::atomic<uint64_t> bytes;
+
+   void reset(){
+      allocations.store(0, std::memory_order_relaxed);
+      frees.store(0, std::memory_order_relaxed);
+      bytes.store(0, std::memory_order_relaxed);
+   }
+
+   AllocStats load() const{
+      return AllocStats{ allocations.load(std::memory_order_relaxed), frees.load(std::memory_order_relaxed), bytes.load(std::memory_order_relaxed) };
+   }
+};
+
+struct Zone{
+   const char* name;
+   Counters frame;
+   AllocStats last;
+};
+
+static Counters totalCounters;
+static Counters frameCounters;
+static AllocStats lastFrameStats;
+
+static Zone zones[MAX_ALLOC_ZONES];
+static std::atomic<int> zoneCount(0);
+static std::atomic_flag zoneLock = ATOMIC_FLAG_INIT;
+static thread_local int currentZone = -1;
+
+static uint64_t frameNumber = 0;
+static uint64_t budgetAllocations = 0;
+static uint64_t budgetBytes = 0;
+static BUDGET_ACTION budgetAction = budgetLog;
+static uint64_t framesOverBudget = 0;
+static uint64_t worstFrameAllocations = 0;
+
+#ifndef NDEBUG
+//Histograma por direccion de retorno de operator new, tabla de direccionamiento abierto fija
+const int MAX_CALL_SITES = 1024;
+
+struct CallSite{
+   void* address;
+   uint64_t allocations;
+   uint64_t bytes;
+};
+
+static CallSite callSites[MAX_CALL_SITES];
+static uint64_t droppedCallSites = 0;
+static std::atomic_flag callSiteLock = ATOMIC_FLAG_INIT;
+
+static void recordCallSite(void* address, size_t size){
+   while (callSiteLock.test_and_set(std::memory_order_acquire)){}
+
+   size_t index = (size_t(uintptr_t(address)) * 0x9E3779B97F4A7C15ull) >> 54;
+   for (int probe = 0; probe < MAX_CALL_SITES; probe++){
+      CallSite& site = callSites[(index + probe) % MAX_CALL_SITES];
+      if (site.address == address || site.address == nullptr){
+         site.address = address;
+         site.allocations++;
+         site.bytes += size;
+         callSiteLock.clear(std::memory_order_release);
+         return;
+      }
+   }
+
+   droppedCallSites++;
+   callSiteLock.clear(std::memory_order_release);
+}
+#endif
+
+static void recordAllocation(size_t size, void* caller){
+   totalCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+   totalCounters.bytes.fetch_add(size, std::memory_order_relaxed);
+   frameCounters.allocations.fetch_add(1, std::memory_order_relaxed);
+   frameCounters.bytes.fetch_add(size, std::memory_order_relaxed);
+
+   int zone = currentZone;
+   if (zone >= 0){
+      zones[zone].frame.allocations.fetch_add(1, std::memory_order_relaxed);
+      zones[zone].frame.bytes.fetch_add(size, std::memory_order_relaxed);
+   }
+
+#ifndef NDEBUG
+   recordCallSite(caller, size);
+#endif
+}
+
+static void recordFree(void* pointer){
+   if (pointer == nullptr)
+      return;
+
+   totalCounters.frees.fetch_add(1, std::memory_order_relaxed);
+   frameCounters.frees.fetch_add(1, std::memory_order_relaxed);
+
+   int zone = currentZone;
+   if (zone >= 0)
+      zones[zone].frame.frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void* allocate(size_t size, void* caller){
+   void* pointer = malloc(size == 0 ? 1 : size);
+   if (pointer == nullptr)
+      return nullptr;
+
+   recordAllocation(size, caller);
+   return pointer;
+}
+
+static void* allocateAligned(size_t size, size_t alignment, void* caller){
+   //aligned_alloc pide que el tamaño sea multiplo del alineamiento
+   size_t rounded = (size + alignment - 1) / alignment * alignment;
+   void* pointer = aligned_alloc(alignment, rounded == 0 ? alignment : rounded);
+   if (pointer == nullptr)
+      return nullptr;
+
+   recordAllocation(size, caller);
+   return pointer;
+}
+
+static void release(void* pointer){
+   recordFree(pointer);
+   free(pointer);
+}
+
+void* operator new(size_t size){
+   void* pointer = allocate(size, __builtin_return_address(0));
+   if (pointer == nullptr)
+      throw std::bad_alloc();
+   return pointer;
+}
+
+void* operator new[](size_t size){
+   void* pointer = allocate(size, __builtin_return_address(0));
+   if (pointer == nullptr)
+      throw std::bad_alloc();
+   return pointer;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept{ return allocate(size, __builtin_return_address(0)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept{ return allocate(size, __builtin_return_address(0)); }
+
+void* operator new(size_t size, std::align_val_t alignment){
+   void* pointer = allocateAligned(size, size_t(alignment), __builtin_return_address(0));
+   if (pointer == nullptr)
+      throw std::bad_alloc();
+   return pointer;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment){
+   void* pointer = allocateAligned(size, size_t(alignment), __builtin_return_address(0));
+   if (pointer == nullptr)
+      throw std::bad_alloc();
+   return pointer;
+}
+
+void operator delete(void* pointer) noexcept{ release(pointer); }
+void operator delete[](void* pointer) noexcept{ release(pointer); }
+void operator delete(void* pointer, size_t) noexcept{ release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept{ release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept{ release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept{ release(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept{ release(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept{ release(pointer); }
+
+bool AllocTracker::enabled(){
+   return true;
+}
+
+void AllocTracker::beginFrame(){
+   frameCounters.reset();
+
+   int count = zoneCount.load(std::memory_order_acquire);
+   for (int i = 0; i < count; i++)
+      zones[i].frame.reset();
+}
+
+AllocStats AllocTracker::endFrame(){
+   lastFrameStats = frameCounters.load();
+
+   int count = zoneCount.load(std::memory_order_acquire);
+   for (int i = 0; i < count; i++)
+      zones[i].last = zones[i].frame.load();
+
+   frameNumber++;
+
+   bool overAllocations = budgetAllocations != 0 && lastFrameStats.allocations > budgetAllocations;
+   bool overBytes = budgetBytes != 0 && lastFrameStats.bytes > budgetBytes;
+   if (overAllocations || overBytes){
+      framesOverBudget++;
+
+      //Solo se avisa cuando se supera el peor frame hasta ahora, para no llenar la consola
+      if (budgetAction == budgetAssert || lastFrameStats.allocations > worstFrameAllocations){
+         worstFrameAllocations = lastFrameStats.allocations;
+         fprintf(stderr, "Frame %llu fuera de presupuesto: %llu reservas, %llu bytes (maximo %llu reservas, %llu bytes)\n",
+                 (unsigned long long)frameNumber, (unsigned long long)lastFrameStats.allocations, (unsigned long long)lastFrameStats.bytes,
+                 (unsigned long long)budgetAllocations, (unsigned long long)budgetBytes);
+      }
+
+      if (budgetAction == budgetAssert){
+         printReport(stderr);
+         abort();
+      }
+   }
+
+   return lastFrameStats;
+}
+
+void AllocTracker::setBudget(uint64_t maxAllocations, uint64_t maxBytes, BUDGET_ACTION action){
+   budgetAllocations = maxAllocations;
+   budgetBytes = maxBytes;
+   budgetAction = action;
+}
+
+AllocStats AllocTracker::lastFrame(){
+   return lastFrameStats;
+}
+
+AllocStats AllocTracker::total(){
+   return totalCounters.load();
+}
+
+void AllocTracker::printReport(FILE* file){
+   AllocStats totalStats = total();
+   fprintf(file, "Reservas totales: %llu (%llu bytes), liberaciones: %llu\n",
+           (unsigned long long)totalStats.allocations, (unsigned long long)totalStats.bytes, (unsigned long long)totalStats.frees);
+   fprintf(file, "Ultimo frame (%llu): %llu reservas, %llu bytes, %llu liberaciones, frames fuera de presupuesto: %llu\n",
+           (unsigned long long)frameNumber, (unsigned long long)lastFrameStats.allocations, (unsigned long long)lastFrameStats.bytes,
+           (unsigned long long)lastFrameStats.frees, (unsigned long long)framesOverBudget);
+
+   int count = zoneCount.load(std::memory_order_acquire);
+   for (int i = 0; i < count; i++){
+      fprintf(file, "  %-20s %8llu reservas %10llu bytes %8llu liberaciones\n", zones[i].name,
+              (unsigned long long)zones[i].last.allocations, (unsigned long long)zones[i].last.bytes, (unsigned long long)zones[i].last.frees);
+   }
+
+#ifndef NDEBUG
+   //Las 20 direcciones con mas reservas, se buscan sin ordenar para no reservar memoria
+   const int TOP = 20;
+   fprintf(file, "Direcciones que mas reservan (desde el inicio):\n");
+
+   while (callSiteLock.test_and_set(std::memory_order_acquire)){}
+   CallSite top[TOP] = {};
+   for (int i = 0; i < MAX_CALL_SITES; i++){
+      if (callSites[i].address == nullptr)
+         continue;
+
+      int position = TOP;
+      while (position > 0 && top[position - 1].allocations < callSites[i].allocations)
+         position--;
+
+      if (position < TOP){
+         memmove(&top[position + 1], &top[position], (TOP - position - 1) * sizeof(CallSite));
+         top[position] = callSites[i];
+      }
+   }
+   uint64_t dropped = droppedCallSites;
+   callSiteLock.clear(std::memory_order_release);
+
+   for (int i = 0; i < TOP && top[i].address != nullptr; i++){
+      fprintf(file, "  %8llu reservas %10llu bytes  ", (unsigned long long)top[i].allocations, (unsigned long long)top[i].bytes);
+#ifdef __GLIBC__
+      //backtrace_symbols_fd escribe directamente en el fichero sin reservar memoria
+      fflush(file);
+      backtrace_symbols_fd(&top[i].address, 1, fileno(file));
+#else
+      fprintf(file, "%p\n", top[i].address);
+#endif
+   }
+
+   if (dropped != 0)
+      fprintf(file, "  %llu reservas sin apuntar (tabla llena)\n", (unsigned long long)dropped);
+#endif
+}
+
+AllocZone::AllocZone(const char* name){
+   previous = currentZone;
+
+   //Las zonas se buscan por el puntero del literal, asi no hace falta comparar texto
+   int count = zoneCount.load(std::memory_order_acquire);
+   for (int i = 0; i < count; i++){
+      if (zones[i].name == name){
+         currentZone = i;
+         return;
+      }
+   }
+
+   while (zoneLock.test_and_set(std::memory_order_acquire)){}
+
+   count = zoneCount.load(std::memory_order_relaxed);
+   int index = -1;
+   for (int i = 0; i < count; i++){
+      if (zones[i].name == name)
+         index = i;
+   }
+
+   if (index < 0 && count < MAX_ALLOC_ZONES){
+      index = count;
+      zones[index].name = name;
+      zoneCount.store(count + 1, std::memory_order_release);
+   }
+
+   zoneLock.clear(std::memory_order_release);
+
+   //Sin sitio para mas zonas se sigue apuntando en la de fuera
+   if (index >= 0)
+      currentZone = index;
+}
+
+AllocZone::~AllocZone(){
+   currentZone = previous;
+}
+
+#endif
@@ -0,0 +1,182 @@
+#include "include/assetPack.h"
+
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+uint64_t assetNameHash(std::string_view name){
+   uint64_t hash = 14695981039346656037ull;
+   for (char c : name){
+      hash ^= uint8_t(c);
+      hash *= 1099511628211ull;
+   }
+
+   return hash != 0 ? hash : 1;
+}
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment){
+   return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool AssetPack::open(const std::string& path){
+   header = nullptr;
+   table = nullptr;
+   if (!file.open(path) || file.size() < sizeof(AssetPackHeader))
+      return false;
+
+   const AssetPackHeader* candidate = (const AssetPackHeader*)file.data();
+   if (memcmp(candidate->magic, "TPAK", 4) != 0 || candidate->version != ASSET_PACK_VERSION)
+      return false;
+
+   //El indice es potencia de 2 y siempre tiene algun hueco, asi find siempre termina
+   uint32_t tableSize = candidate->tableSize;
+   if (tableSize == 0 || (tableSize & (tableSize - 1)) != 0 || candidate->entryCount >= tableSize)
+      return false;
+
+   uint64_t tableEnd = sizeof(AssetPackHeader) + uint64_t(tableSize) * sizeof(AssetPackEntry);
+   if (tableEnd > file.size() || candidate->namesOffset < tableEnd || candidate->namesOffset > file.size())
+      return false;
+
+   const AssetPackEntry* entries = (const AssetPackEntry*)(file.data() + sizeof(AssetPackHeader));
+   uint32_t used = 0;
+   for (uint32_t i = 0; i < tableSize; i++){
+      const AssetPackEntry& entry = entries[i];
+      if (entry.hash == 0)
+         continue;
+
+      used++;
+      if (candidate->namesOffset + entry.nameOffset + entry.nameLength > file.size())
+         return false;
+      if (entry.offset > file.size() || entry.size > file.size() - entry.offset)
+         return false;
+   }
+
+   if (used != candidate->entryCount)
+      return false;
+
+   header = candidate;
+   table = entries;
+   return true;
+}
+
+AssetSpan AssetPack::find(std::string_view name) const{
+   if (header == nullptr)
+      return AssetSpan();
+
+   uint64_t hash = assetNameHash(name);
+   uint32_t mask = header->tableSize - 1;
+   const char* names = (const char*)file.data() + header->namesOffset;
+
+   for (uint32_t i = uint32_t(hash) & mask; table[i].hash != 0; i = (i + 1) & mask){
+      const AssetPackEntry& entry = table[i];
+      if (entry.hash == hash && std::string_view(names + entry.nameOffset, entry.nameLength) == name)
+         return AssetSpan{ file.data() + entry.offset, size_t(entry.size) };
+   }
+
+   return AssetSpan();
+}
+
+void AssetPackWriter::add(std::string name, std::vector<uint8_t> data){
+   assets.push_back(PendingAsset{ std::move(name), std::move(data) });
+}
+
+bool AssetPackWriter::write(const std::string& path) const{
+   //Como minimo la mitad del indice vacio
+   uint32_t tableSize = 16;
+   while (tableSize < assets.size() * 2)
+      tableSize *= 2;
+
+   std::vector<AssetPackEntry> table(tableSize, AssetPackEntry{ 0, 0, 0, 0, 0 });
+   std::string names;
+
+   AssetPackHeader header = {};
+   memcpy(header.magic, "TPAK", 4);
+   header.version = ASSET_PACK_VERSION;
+   header.entryCount = uint32_t(assets.size());
+   header.tableSize = tableSize;
+   header.namesOffset = sizeof(AssetPackHeader) + uint64_t(tableSize) * sizeof(AssetPackEntry);
+
+   for (const PendingAsset& asset : assets)
+      names += asset.name;
+
+   uint64_t offset = alignUp(header.namesOffset + names.size(), 16);
+   uint32_t nameOffset = 0;
+   for (const PendingAsset& asset : assets){
+      uint64_t hash = assetNameHash(asset.name);
+      uint32_t slot = uint32_t(hash) & (tableSize - 1);
+      while (table[slot].hash != 0){
+         const AssetPackEntry& other = table[slot];
+         if (other.hash == hash && names.compare(other.nameOffset, other.nameLength, asset.name) == 0)
+            return false;
+
+         slot = (slot + 1) & (tableSize - 1);
+      }
+
+      table[slot] = AssetPackEntry{ hash, offset, asset.data.size(), nameOffset, uint32_t(asset.name.size()) };
+      nameOffset += uint32_t(asset.name.size());
+      offset = alignUp(offset + asset.data.size(), 16);
+   }
+
+   std::ofstream file(path, std::ios::binary);
+   if (!file)
+      return false;
+
+   file.write((const char*)&header, sizeof(header));
+   file.write((const char*)table.data(), table.size() * sizeof(AssetPackEntry));
+   file.write(names.data(), names.size());
+
+   //Los datos en el mismo orden en el que se han añadido, con el relleno hasta 16 bytes
+   const char padding[16] = {};
+   uint64_t position = header.namesOffset + names.size();
+   for (const PendingAsset& asset : assets){
+      file.write(padding, alignUp(position, 16) - position);
+      position = alignUp(position, 16);
+
+      file.write((const char*)asset.data.data(), asset.data.size());
+      position += asset.data.size();
+   }
+
+   return bool(file);
+}
+
+std::string executableDirectory(){
+   char path[4096];
+   ssize_t length = readlink("/proc/self/exe", path, sizeof(path) - 1);
+   if (length <= 0)
+      return "./";
+
+   std::string directory(path, size_t(length));
+   return directory.substr(0, directory.find_last_of('/') + 1);
+}
+
+const AssetPack& Asset::pack(){
+   static AssetPack sharedPack;
+   static bool opened = sharedPack.open(executableDirectory() + ASSET_PACK_NAME);
+   (void)opened;
+
+   return sharedPack;
+}
+
+std::string Asset::loosePath(std::string_view name){
+   static const std::string root = executableDirectory() + "../assets/";
+   return root + std::string(name);
+}
+
+bool Asset::load(std::string_view name){
+   file.close();
+
+   span = pack().find(name);
+   if (span)
+      return true;
+
+   return loadFile(name);
+}
+
+bool Asset::loadFile(std::string_view name){
+   span = AssetSpan();
+   if (!file.open(loosePath(name)))
+      return false;
+
+   span = AssetSpan{ file.data(), file.size() };
+   return true;
+}
@@ -0,0 +1,121 @@
+#include "include/assetWatcher.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <filesystem>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+AssetWatcher::AssetWatcher(): inotifyDescriptor(-1), wakeDescriptor(-1), hasPending(false){}
+
+AssetWatcher::~AssetWatcher(){
+   stop();
+}
+
+bool AssetWatcher::start(const std::string& root){
+   stop();
+
+   inotifyDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+   if (inotifyDescriptor < 0 || wakeDescriptor < 0){
+      stop();
+      return false;
+   }
+
+   //Las mismas carpetas que van al pack. Los editores suelen guardar en otro archivo y renombrarlo, de ahi IN_MOVED_TO
+   std::error_code error;
+   for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(root, error)){
+      if (!entry.is_directory())
+         continue;
+
+      int watch = inotify_add_watch(inotifyDescriptor, entry.path().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+      if (watch >= 0)
+         directories.push_back(std::make_pair(watch, entry.path().filename().string()));
+   }
+
+   if (directories.empty()){
+      stop();
+      return false;
+   }
+
+   thread = std::thread(&AssetWatcher::run, this);
+   return true;
+}
+
+void AssetWatcher::stop(){
+   if (thread.joinable()){
+      uint64_t one = 1;
+      ssize_t written = write(wakeDescriptor, &one, sizeof(one));
+      (void)written;
+      thread.join();
+   }
+
+   if (inotifyDescriptor >= 0)
+      close(inotifyDescriptor);
+   if (wakeDescriptor >= 0)
+      close(wakeDescriptor);
+
+   inotifyDescriptor = -1;
+   wakeDescriptor = -1;
+   directories.clear();
+}
+
+bool AssetWatcher::takeChanges(std::vector<std::string>& changed){
+   if (!hasPending.load(std::memory_order_acquire))
+      return false;
+
+   std::lock_guard<std::mutex> lock(pendingMutex);
+   changed.swap(pending);
+   pending.clear();
+   hasPending.store(false, std::memory_order_relaxed);
+   return !changed.empty();
+}
+
+void AssetWatcher::run(){
+   //Alineado como struct inotify_event, caben varios eventos por lectura
+   alignas(inotify_event) char buffer[4096];
+
+   pollfd descriptors[2] = {
+      { inotifyDescriptor, POLLIN, 0 },
+      { wakeDescriptor, POLLIN, 0 }
+   };
+
+   while (true){
+      if (poll(descriptors, 2, -1) < 0){
+         if (errno == EINTR)
+            continue;
+         return;
+      }
+
+      //stop() escribe en el eventfd
+      if (descriptors[1].revents & POLLIN)
+         return;
+
+      ssize_t length;
+      while ((length = read(inotifyDescriptor, buffer, sizeof(buffer))) > 0){
+         std::lock_guard<std::mutex> lock(pendingMutex);
+
+         for (ssize_t offset = 0; offset < length;){
+            const inotify_event* event = (const inotify_event*)(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->len == 0)
+               continue;
+
+            for (const std::pair<int, std::string>& directory : directories){
+               if (directory.first != event->wd)
+                  continue;
+
+               std::string name = directory.second + "/" + event->name;
+               if (std::find(pending.begin(), pending.end(), name) == pending.end())
+                  pending.push_back(name);
+            }
+         }
+
+         hasPending.store(!pending.empty(), std::memory_order_release);
+      }
+   }
+}
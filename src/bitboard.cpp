@@ -0,0 +1,208 @@
+#include "include/bitboard.h"
+#include "include/board.h"
+#include "include/piece.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+Bitboard::Bitboard(){
+   std::memset(rows, 0, sizeof(rows));
+}
+
+Bitboard::Bitboard(const Board& board){
+   std::memset(rows, 0, sizeof(rows));
+
+   for (int i = 0; i < 10; i++){
+      for (int j = 0; j < 20; j++){
+         if (board.pieces[i][j].color != empty)
+            row(j) |= uint16_t(1 << i);
+      }
+   }
+}
+
+//Comprueba si la pieza cabe en (x, y) sin salirse ni chocar
+bool Bitboard::fits(const PieceMask& piece, int x, int y) const{
+   for (int j = 0; j < piece.size; j++){
+      if (piece.rows[j] == 0)
+         continue;
+
+      if (y + j > 19 || y + j < 0)
+         return false;
+
+      uint32_t shifted = x >= 0 ? uint32_t(piece.rows[j]) << x : uint32_t(piece.rows[j]) >> -x;
+      if (x < 0 && (piece.rows[j] & ((1 << -x) - 1)))
+         return false;
+      if (shifted & ~uint32_t(fullRow))
+         return false;
+      if (shifted & row(y + j))
+         return false;
+   }
+
+   return true;
+}
+
+//Fila en la que se queda la pieza al dejarla caer desde (x, y)
+int Bitboard::dropRow(const PieceMask& piece, int x, int y) const{
+   while (fits(piece, x, y + 1))
+      y++;
+
+   return y;
+}
+
+void Bitboard::place(const PieceMask& piece, int x, int y){
+   for (int j = 0; j < piece.size; j++){
+      if (piece.rows[j] != 0)
+         row(y + j) |= uint16_t(x >= 0 ? piece.rows[j] << x : piece.rows[j] >> -x);
+   }
+}
+
+//Quita las filas llenas y devuelve cuantas habia
+int Bitboard::clearLines(){
+#if defined(__SSE2__)
+   //Caso comun: ninguna fila llena, se descarta con tres comparaciones
+   const __m128i full = _mm_set1_epi16(fullRow);
+   int mask = 0;
+   for (int k = 0; k < 3; k++){
+      __m128i r = _mm_load_si128((const __m128i*)(rows + k * 8));
+      mask |= _mm_movemask_epi8(_mm_cmpeq_epi16(r, full));
+   }
+   if (mask == 0)
+      return 0;
+#endif
+
+   int cleared = 0;
+   int write = 19;
+   for (int read = 19; read >= 0; read--){
+      if (row(read) == fullRow){
+         cleared++;
+         continue;
+      }
+
+      row(write--) = row(read);
+   }
+   while (write >= 0)
+      row(write--) = 0;
+
+   return cleared;
+}
+
+#if defined(__SSE2__)
+//Suma de bits a 1 de todo el registro
+static inline int popcount128(__m128i x){
+   const __m128i m1 = _mm_set1_epi8(0x55);
+   const __m128i m2 = _mm_set1_epi8(0x33);
+   const __m128i m4 = _mm_set1_epi8(0x0F);
+
+   x = _mm_sub_epi8(x, _mm_and_si128(_mm_srli_epi16(x, 1), m1));
+   x = _mm_add_epi8(_mm_and_si128(x, m2), _mm_and_si128(_mm_srli_epi16(x, 2), m2));
+   x = _mm_and_si128(_mm_add_epi8(x, _mm_srli_epi16(x, 4)), m4);
+   x = _mm_sad_epu8(x, _mm_setzero_si128());
+
+   return _mm_cvtsi128_si32(x) + _mm_extract_epi16(x, 4);
+}
+
+//OR acumulado de arriba a abajo dentro del registro (cada fila pasa a incluir las de encima)
+static inline __m128i prefixOr(__m128i x){
+   x = _mm_or_si128(x, _mm_slli_si128(x, 2));
+   x = _mm_or_si128(x, _mm_slli_si128(x, 4));
+   x = _mm_or_si128(x, _mm_slli_si128(x, 8));
+   return x;
+}
+
+//Copia la ultima fila del registro en todas
+static inline __m128i broadcastLast(__m128i x){
+   x = _mm_shufflehi_epi16(x, 0xFF);
+   return _mm_unpackhi_epi64(x, x);
+}
+#endif
+
+//Altura total, huecos y desnivel entre columnas
+BoardFeatures Bitboard::features() const{
+   BoardFeatures result;
+   int heights[10];
+
+#if defined(__SSE2__)
+   __m128i r0 = _mm_load_si128((const __m128i*)(rows + 0));
+   __m128i r1 = _mm_load_si128((const __m128i*)(rows + 8));
+   __m128i r2 = _mm_load_si128((const __m128i*)(rows + 16));
+
+   //Una casilla esta "cubierta" si ella o alguna de encima esta ocupada
+   __m128i c0 = prefixOr(r0);
+   __m128i c1 = _mm_or_si128(prefixOr(r1), broadcastLast(c0));
+   __m128i c2 = _mm_or_si128(prefixOr(r2), broadcastLast(c1));
+
+   //La altura de una columna es el numero de filas cubiertas y los huecos las cubiertas vacias
+   result.aggregateHeight = popcount128(c0) + popcount128(c1) + popcount128(c2);
+   result.holes = popcount128(_mm_andnot_si128(r0, c0)) + popcount128(_mm_andnot_si128(r1, c1)) + popcount128(_mm_andnot_si128(r2, c2));
+
+   const __m128i one = _mm_set1_epi16(1);
+   for (int i = 0; i < 10; i++){
+      __m128i sum = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(c0, i), one),
+                    _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(c1, i), one), _mm_and_si128(_mm_srli_epi16(c2, i), one)));
+      sum = _mm_sad_epu8(sum, _mm_setzero_si128());
+      heights[i] = _mm_cvtsi128_si32(sum) + _mm_extract_epi16(sum, 4);
+   }
+#else
+   uint16_t covered = 0;
+   result.aggregateHeight = 0;
+   result.holes = 0;
+   for (int i = 0; i < 10; i++)
+      heights[i] = 0;
+
+   for (int j = 0; j < 20; j++){
+      covered |= row(j);
+      result.aggregateHeight += __builtin_popcount(covered);
+      result.holes += __builtin_popcount(covered & ~row(j));
+   }
+
+   for (int i = 0; i < 10; i++){
+      for (int j = 0; j < 20; j++){
+         if (row(j) & (1 << i)){
+            heights[i] = 20 - j;
+            break;
+         }
+      }
+   }
+#endif
+
+   result.bumpiness = 0;
+   for (int i = 0; i < 9; i++){
+      int difference = heights[i] - heights[i + 1];
+      result.bumpiness += difference < 0 ? -difference : difference;
+   }
+
+   return result;
+}
+
+//Convierte la forma de la pieza (4 bits por fila) a mascaras por fila
+PieceMask pieceMaskFromPiece(const MovingPiece& movingPiece){
+   PieceMask piece;
+   piece.size = movingPiece.size;
+
+   for (int j = 0; j < 4; j++)
+      piece.rows[j] = (movingPiece.shape >> (4 * j)) & 0xF;
+
+   return piece;
+}
+
+//La misma rotacion que MovingPiece::rotateLeft: new[n-1-j][i] = old[i][j]
+PieceMask rotatePieceMask(const PieceMask& piece){
+   PieceMask rotated;
+   rotated.size = piece.size;
+
+   for (int j = 0; j < 4; j++)
+      rotated.rows[j] = 0;
+
+   for (int i = 0; i < piece.size; i++){
+      for (int j = 0; j < piece.size; j++){
+         if (piece.rows[j] & (1 << i))
+            rotated.rows[i] |= uint16_t(1 << (piece.size - 1 - j));
+      }
+   }
+
+   return rotated;
+}
@@ -1,5 +1,4 @@
 #include "include/board.h"
-#include "include/engine.h"
 #include "include/piece.h"
 #include <algorithm>
 #include <cmath>
@@ -7,13 +6,98 @@
 #include <math.h>
 
 Board::Board(){
+   reset();
+}
+
+//Vacia el tablero y el mapa de alturas
+void Board::reset(){
    for (int i = 0; i < 10; i++)
    {
       for (int j = 0; j < 20; j++)
       {
          pieces[i][j] = Piece(empty);
       }
+
+      heights[i] = 0;
+   }
+}
+
+//Fija una casilla y actualiza la altura de su columna
+void Board::lockCell(int x, int y, COLOR color){
+   pieces[x][y].color = color;
+
+   heights[x] = std::max(heights[x], 20 - y);
+}
+
+//Elimina una fila llena, baja las de encima y actualiza las alturas
+void Board::clearRow(int row){
+   for (int i = 0; i < 10; i++){
+      for (int j = row; j > 0; j--){
+         pieces[i][j] = pieces[i][j - 1];
+      }
+      pieces[i][0] = Piece(empty);
+
+      //Si la columna tiene casillas encima de la fila simplemente baja una
+      if (20 - heights[i] < row){
+         heights[i]--;
+         continue;
+      }
+
+      //Si la fila era la cima hay que buscar la siguiente casilla ocupada por debajo
+      int top = row + 1;
+      while (top < 20 && pieces[i][top].color == empty)
+         top++;
+
+      heights[i] = 20 - top;
+   }
+}
+
+//Devuelve la fila en la que se quedaria la pieza si se dejase caer desde (x, y)
+int Board::dropRow(int x, int y, uint16_t shape, int size){
+   int landing = 20;
+
+   //Con el mapa de alturas solo hace falta la casilla mas baja de cada columna de la pieza
+   for (int i = 0; i < size; i++){
+      int bottom = -1;
+      for (int j = 0; j < size; j++){
+         if (shape & (1 << (i + 4 * j)))
+            bottom = j;
+      }
+
+      if (bottom == -1)
+         continue;
+
+      landing = std::min(landing, 20 - heights[x + i] - 1 - bottom);
+   }
+
+   if (landing >= y)
+      return landing;
+
+   //La pieza esta debajo de un saliente, se baja casilla a casilla desde donde esta
+   landing = y;
+   while (true){
+      for (int i = 0; i < size; i++){
+         for (int j = 0; j < size; j++){
+            if (shape & (1 << (i + 4 * j))){
+               if (landing + j + 1 >= 20 || pieces[x + i][landing + j + 1].color != empty)
+                  return landing;
+            }
+         }
+      }
+
+      landing++;
    }
 }
 
+//Hash FNV-1a de las casillas, para comparar tableros rapido
+uint64_t Board::hash() const{
+   uint64_t result = 0xCBF29CE484222325ull;
 
+   for (int i = 0; i < 10; i++){
+      for (int j = 0; j < 20; j++){
+         result = (result ^ uint64_t(pieces[i][j].color)) * 0x100000001B3ull;
+      }
+   }
+
+   return result;
+}
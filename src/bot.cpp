@@ -0,0 +1,154 @@
+#include "include/bot.h"
+#include "include/bitboard.h"
+#include "include/simulation.h"
+
+#include <cstring>
+
+//Pesos de las caracteristicas del tablero
+const double HEIGHT_WEIGHT = -0.510066;
+const double LINES_WEIGHT = 0.760666;
+const double HOLES_WEIGHT = -0.35663;
+const double BUMPINESS_WEIGHT = -0.184483;
+
+//Puntuacion de las colocaciones que hacen perder
+const double LOSING_SCORE = -1e9;
+
+static bool sameShape(const PieceMask& a, const PieceMask& b){
+   return std::memcmp(a.rows, b.rows, sizeof(a.rows)) == 0;
+}
+
+//Siguiente paso para llegar a la colocacion: primero rotar, despues mover y al final soltar
+static INPUT stepTowards(const Placement& plan, const MovingPiece& movingPiece){
+   if (!sameShape(pieceMaskFromPiece(movingPiece), plan.piece))
+      return inputRotate;
+   if (movingPiece.currentX < plan.x)
+      return inputRight;
+   if (movingPiece.currentX > plan.x)
+      return inputLeft;
+
+   return inputHardDrop;
+}
+
+//Si la pieza cabe despues de ese paso donde esta ahora
+static bool stepFits(const Bitboard& board, const MovingPiece& movingPiece, INPUT input){
+   PieceMask piece = pieceMaskFromPiece(movingPiece);
+   switch (input){
+      case inputRotate:
+         return board.fits(rotatePieceMask(piece), movingPiece.currentX, movingPiece.currentY);
+      case inputLeft:
+         return board.fits(piece, movingPiece.currentX - 1, movingPiece.currentY);
+      case inputRight:
+         return board.fits(piece, movingPiece.currentX + 1, movingPiece.currentY);
+      default:
+         return true;
+   }
+}
+
+//Decide la tecla de este tick siguiendo el plan de la pieza actual
+INPUT Bot::nextInput(const Simulation& simulation){
+   //Hay pieza nueva (o partida nueva), se vuelve a buscar la mejor colocacion
+   if (!hasPlan || plannedPiece != simulation.state.piecesPlaced || simulation.state.ticks < lastTick){
+      plan = findPlacement(simulation);
+      plannedPiece = simulation.state.piecesPlaced;
+      hasPlan = true;
+   }
+   lastTick = simulation.state.ticks;
+
+   const MovingPiece& movingPiece = simulation.state.movingPiece;
+   INPUT input = stepTowards(plan, movingPiece);
+
+   //El plan se hizo mas arriba, mientras se espera a poder rotar o mover la pieza cae y el camino se puede cerrar
+   //Entonces se busca otra vez desde aqui, solo con las rotaciones y columnas que se alcanzan ahora (la actual siempre)
+   if (!stepFits(Bitboard(simulation.state.board), movingPiece, input)){
+      plan = findPlacement(simulation);
+      input = stepTowards(plan, movingPiece);
+   }
+
+   return input;
+}
+
+//Recorre las colocaciones alcanzables: rotando donde esta la pieza y despues moviendola a cada lado mientras quepa
+template<typename F>
+static void forEachPlacement(const Bitboard& board, PieceMask piece, int x, int y, F visit){
+   PieceMask rotations[4];
+   int rotationCount = 0;
+
+   for (int rotation = 0; rotation < 4; rotation++){
+      if (rotation > 0)
+         piece = rotatePieceMask(piece);
+
+      //Si no se puede rotar aqui tampoco se llega a las siguientes rotaciones
+      if (!board.fits(piece, x, y))
+         return;
+
+      bool repeated = false;
+      for (int i = 0; i < rotationCount; i++)
+         repeated = repeated || sameShape(rotations[i], piece);
+      if (repeated)
+         continue;
+      rotations[rotationCount++] = piece;
+
+      for (int direction = -1; direction <= 1; direction += 2){
+         for (int targetX = direction == -1 ? x : x + 1; board.fits(piece, targetX, y); targetX += direction){
+            visit(piece, targetX, board.dropRow(piece, targetX, y));
+         }
+      }
+   }
+}
+
+//Busca la mejor colocacion de la pieza actual mirando tambien la siguiente
+Placement Bot::findPlacement(const Simulation& simulation){
+   Bitboard board(simulation.state.board);
+   const MovingPiece& movingPiece = simulation.state.movingPiece;
+
+   PieceMask piece = pieceMaskFromPiece(movingPiece);
+   PieceMask next = pieceMaskFromPiece(simulation.state.nextPiece);
+
+   Placement best = Placement{ piece, movingPiece.currentX, LOSING_SCORE * 2 };
+
+   forEachPlacement(board, piece, movingPiece.currentX, movingPiece.currentY, [&](const PieceMask& placed, int x, int landing){
+      Bitboard after = board;
+      after.place(placed, x, landing);
+      int lines = after.clearLines();
+
+      double score = LOSING_SCORE;
+      if (landing > placed.size)
+         score = lines * LINES_WEIGHT + bestScore(after, next);
+
+      if (score > best.score)
+         best = Placement{ placed, x, score };
+   });
+
+   return best;
+}
+
+//Mejor puntuacion que se puede sacar colocando la pieza en el tablero
+double Bot::bestScore(const Bitboard& board, const PieceMask& piece){
+   double best = LOSING_SCORE;
+
+   forEachPlacement(board, piece, 5 - piece.size / 2, 0, [&](const PieceMask& placed, int x, int landing){
+      if (landing <= placed.size)
+         return;
+
+      Bitboard after = board;
+      after.place(placed, x, landing);
+      int lines = after.clearLines();
+
+      double score = evaluate(after, lines);
+      if (score > best)
+         best = score;
+   });
+
+   return best;
+}
+
+double Bot::evaluate(const Bitboard& board, int lines){
+   evaluatedPlacements++;
+
+   BoardFeatures features = board.features();
+
+   return features.aggregateHeight * HEIGHT_WEIGHT
+        + lines * LINES_WEIGHT
+        + features.holes * HOLES_WEIGHT
+        + features.bumpiness * BUMPINESS_WEIGHT;
+}
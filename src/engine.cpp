@@ -1,8 +1,12 @@
 #include "include/engine.h"
+#include "include/allocTracker.h"
 #include "include/glm/fwd.hpp"
-#include "include/rendering/sprite.h"
+#define STB_IMAGE_IMPLEMENTATION
 #include "include/rendering/stb_image.h"
+#include "include/assetPack.h"
+#include "include/rendering/programCache.h"
 #include "include/rendering/text.h"
+#include "include/startupTrace.h"
 #include <algorithm>
 #include <cstdio>
 #include <glad/glad.h>
@@ -11,25 +15,52 @@
 #include <functional>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 #include <chrono>
 #include <include/glm/glm.hpp>
 #include <include/glm/gtc/matrix_transform.hpp>
+#include <include/glm/gtc/type_ptr.hpp>
 
 int w_width;
 int w_heigth;
-//Cambia el viewport segun se redimensione la pantalla
+//Uniform buffers con la proyeccion de pixeles a coordenadas normalizadas, los shaders la leen en el bloque "Projection"
+//projectionUBO lleva ademas la camara (sprites y tilemaps), screenUBO solo la ventana (textos)
+unsigned int projectionUBO = 0;
+unsigned int screenUBO = 0;
+
+static void uploadProjection(unsigned int buffer, const glm::mat4& projection){
+   glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+   glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4), glm::value_ptr(projection));
+   glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+static glm::mat4 windowProjection(int width, int height){
+   return glm::ortho(0.0f, float(width), 0.0f, float(height), -1.0f, 1.0f);
+}
+
+//Recalcula la proyeccion de los textos, solo hace falta cuando cambia el tamaño de la ventana
+//La de la camara se rehace en render al cambiar su viewport
+static void updateProjection(int width, int height){
+   uploadProjection(screenUBO, windowProjection(width, height));
+}
+
+//Cambia el viewport y la proyeccion segun se redimensione la pantalla
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
    w_width = width;
    w_heigth = height;
    glViewport(0, 0, width, height);
+   updateProjection(width, height);
 }
 
 //El constructor de la clase Engine
-Engine::Engine(int window_width, int window_heigth): sprites(std::vector<Sprite*>()){
+Engine::Engine(int window_width, int window_heigth){
    //Esta parte inicializa glfw
+   StartupPhase initPhase("glfwInit");
    glfwInit();     
+   initPhase.end();
+
    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
@@ -40,7 +71,9 @@ Engine::Engine(int window_width, int window_heigth): sprites(std::vector<Sprite*
    w_width = window_width;
    w_heigth = window_heigth;
 
+   StartupPhase windowPhase("window");
    _window = glfwCreateWindow(w_width, w_heigth, "Tetris", NULL, NULL);
+   windowPhase.end();
    
    if (_window == NULL)
    {
@@ -49,17 +82,39 @@ Engine::Engine(int window_width, int window_heigth): sprites(std::vector<Sprite*
       return;
    }
 
+   StartupPhase contextPhase("context");
    glfwMakeContextCurrent(_window);
+   contextPhase.end();
 
    //Inicializa GLAD
-   if(!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+   StartupPhase gladPhase("gladLoad");
+   bool gladLoaded = gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
+   gladPhase.end();
+   if(!gladLoaded)
    {
       std::cout << "Failed to initialize GLAD" << std::endl;
       return;
    }
 
+   //Antes de crear cualquier shader
+   StartupPhase cachePhase("shaderCache");
+   ProgramCache::init();
+   cachePhase.end();
+
    //Establece el viewport 
    glViewport(0, 0, w_width, w_heigth);
+
+   glGenBuffers(1, &projectionUBO);
+   glGenBuffers(1, &screenUBO);
+   for (unsigned int buffer : { projectionUBO, screenUBO }){
+      glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+      glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4), nullptr, GL_DYNAMIC_DRAW);
+   }
+   updateProjection(w_width, w_heigth);
+
+   //Sin mover nada la camara ve lo mismo que antes: la ventana con (0, 0) abajo a la izquierda, tambien al cambiar de tamaño
+   camera.setViewport(glm::vec2(w_width, w_heigth));
+
    glfwSetFramebufferSizeCallback(_window, framebuffer_size_callback);
 
    //Procesamiento de input
@@ -67,9 +122,10 @@ Engine::Engine(int window_width, int window_heigth): sprites(std::vector<Sprite*
 
    glfwSetKeyCallback(this->_window, Engine::key_callback_static);
 
-   Shader backgroundShader = Shader("../assets/shader/shader.vs", "../assets/shader/shader.fs"); 
+   spriteRenderer = new SpriteRenderer();
+   tilemapRenderer = new TilemapRenderer();
 
-   background = new Sprite("../assets/textures/background.png", w_width * 0.5, w_heigth * 0.5, w_width, w_heigth, backgroundShader);
+   background = addSprite("textures/background.png", w_width * 0.5, w_heigth * 0.5, w_width, w_heigth, 0);
 };
 
 //inicializa el bucle de renderizado
@@ -84,10 +140,28 @@ void Engine::Init(){
 
    while(!glfwWindowShouldClose(_window))
    {
+      reloadChangedAssets();
+
       if (!pause_thread)
       {
-         update();
-         render();
+         AllocTracker::beginFrame();
+         {
+            AllocZone zone("update");
+            update();
+         }
+         {
+            AllocZone zone("render");
+            render();
+         }
+         AllocTracker::endFrame();
+
+         //Con --startup-trace el juego se cierra al presentar el primer frame
+         if (StartupTrace::running()){
+            if (!StartupTrace::finish())
+               std::cout << "No se puede escribir el informe de arranque" << std::endl;
+            glfwSetWindowShouldClose(_window, true);
+         }
+
           // Incrementa el contador de fotogramas
          frameCount++;
 
@@ -99,6 +173,10 @@ void Engine::Init(){
          if (deltaTime >= 1) {
             double fps = static_cast<double>(frameCount) / deltaTime;
             std::cout << "FPS: " << fps << std::endl;
+            std::cout << "Sprites: " << stats.drawnSprites << " drawn, " << stats.culledSprites << " culled; chunks: " << stats.drawnChunks
+                      << " drawn, " << stats.culledChunks << " culled; draw calls: " << stats.drawCalls << std::endl;
+            if (AllocTracker::enabled())
+               std::cout << "Allocations last frame: " << AllocTracker::lastFrame().allocations << std::endl;
 
             // Reinicia el contador y el temporizador
             frameCount = 0;
@@ -109,6 +187,9 @@ void Engine::Init(){
 
    stopEngine();
 
+   if (AllocTracker::enabled())
+      AllocTracker::printReport(stdout);
+
    return;
 };
 
@@ -120,25 +201,67 @@ void Engine::render(){
    glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
    glClear(GL_COLOR_BUFFER_BIT);
 
-   background->render(w_width, w_heigth);
-
-   if (sprites.size() != 0){
-      for (Sprite* sprite : sprites){
-         sprite->render(w_width, w_heigth);
-      }
+   //La proyeccion del mundo solo se vuelve a subir si la camara o la ventana han cambiado
+   camera.setViewport(glm::vec2(w_width, w_heigth));
+   if (camera.getRevision() != uploadedCameraRevision){
+      Affine2D view = camera.worldToScreen();
+      glm::mat4 viewMatrix(view.a, view.b, 0, 0,
+                           view.c, view.d, 0, 0,
+                           0, 0, 1, 0,
+                           view.tx, view.ty, 0, 1);
+      uploadProjection(projectionUBO, windowProjection(w_width, w_heigth) * viewMatrix);
+      uploadedCameraRevision = camera.getRevision();
    }
-   if (texts.size() != 0){
-      for (Text* text : texts){
-         text->render(w_width, w_heigth);
+
+   glm::vec2 viewMin, viewMax;
+   camera.visibleBounds(viewMin, viewMax);
+   glBindBufferBase(GL_UNIFORM_BUFFER, PROJECTION_BINDING, projectionUBO);
+
+   //Todos los sprites visibles, el fondo incluido, de una vez
+   sprites.updateModels();
+   spriteRenderer->render(sprites, viewMin, viewMax);
+
+   //Solo se dibujan los chunks que se ven
+   tilemapRenderer->beginFrame();
+   for (Tilemap* tilemap : tilemaps)
+      tilemapRenderer->render(*tilemap, viewMin, viewMax);
+
+   //Los textos van en pixeles de la ventana, la camara no les afecta
+   glBindBufferBase(GL_UNIFORM_BUFFER, PROJECTION_BINDING, screenUBO);
+   stats.drawnTexts = 0;
+   stats.culledTexts = 0;
+   for (Text* text : texts){
+      glm::vec2 textMin, textMax;
+      text->getBounds(textMin, textMax);
+      if (textMin.x > float(w_width) || textMax.x < 0 || textMin.y > float(w_heigth) || textMax.y < 0 || textMin.x > textMax.x){
+         stats.culledTexts++;
+         continue;
       }
+
+      text->render();
+      stats.drawnTexts++;
    }
+
+   stats.drawnSprites = spriteRenderer->drawnSprites;
+   stats.culledSprites = spriteRenderer->culledSprites;
+   stats.drawnChunks = tilemapRenderer->visibleChunks;
+   stats.culledChunks = tilemapRenderer->culledChunks;
+   stats.drawCalls = spriteRenderer->drawCalls + tilemapRenderer->drawCalls + int(stats.drawnTexts);
    
-   glfwSwapBuffers(_window);
+   {
+      //Solo cuenta en el primer frame, con --startup-trace
+      StartupPhase phase("firstSwap");
+      glfwSwapBuffers(_window);
+   }
    glfwPollEvents();
 }
 
 //procesar el input
 void Engine::processInput(int key, int action){
+   //Solo se procesan las pulsaciones, al soltar la tecla no se hace nada
+   if (action == GLFW_RELEASE)
+      return;
+
    for (size_t i = 0; i < inputCallBackFunctions.size(); i++) {
       inputCallBackFunctions[i]->processInput(key);
    }
@@ -151,42 +274,85 @@ void Engine::update(){
 };
 
 //Añadir un sprite a la lista
-Sprite* Engine::addSprite(std::string pathToTexture, float xPos, float yPos, float width, float height){
-   editing_sprites = true;
-   Sprite* objToAdd = new Sprite(pathToTexture,xPos, yPos, width, height);
-
-   sprites.push_back(objToAdd);
+//La referencia que da load es la del sprite
+SpriteHandle Engine::addSprite(std::string textureName, float xPos, float yPos, float width, float height, uint8_t layer){
+   TextureHandle texture = textures.load(textureName, TextureOptions{ textureRGB });
 
+   editing_sprites = true;
+   SpriteHandle handle = sprites.add(textures.glTexture(texture), xPos, yPos, width, height, layer);
    editing_sprites = false;
 
-   return objToAdd;
+   return handle;
 }
 
-void Engine::addSprite(Sprite* sprite){
+//Si la textura es del manager el sprite se queda con una referencia
+SpriteHandle Engine::addSprite(unsigned int texture, float xPos, float yPos, float width, float height, uint8_t layer){
+   textures.acquire(textures.find(texture));
+
    editing_sprites = true;
-   sprites.push_back(sprite);
+   SpriteHandle handle = sprites.add(texture, xPos, yPos, width, height, layer);
    editing_sprites = false;
+
+   return handle;
 }
 
-Text* Engine::addText(std::string text, int xPos, int yPos, int height){
-   Text* textToAdd = new Text(text, xPos, yPos, height,createRGBTexture("../assets/textures/bitmapFont.png"));
+Text* Engine::addText(std::string_view text, int xPos, int yPos, int height){
+   //La fuente se carga una vez, el engine tiene su referencia hasta stopEngine
+   if (!textures.contains(bitmapFont))
+      bitmapFont = textures.load("textures/bitmapFont.png", TextureOptions{ textureRGB });
+
+   Text* textToAdd = new Text(text, xPos, yPos, height, textures, bitmapFont);
 
    texts.push_back(textToAdd);
 
    return textToAdd;
 }
 
-//quitar un sprite y eliminarlo
-void Engine::removeSprite(Sprite* sprite){
-   for (int i = 0; i < sprites.size(); i++){
-      if (sprites[i] == sprite){
-         editing_sprites = true;
-         sprites.erase(sprites.begin() + i);
-         delete sprite;
-         editing_sprites = false;
-         return;
-      }
-   } 
+glm::vec2 Engine::getWindowSize(){
+   return glm::vec2(w_width, w_heigth);
+}
+
+glm::vec2 Engine::getCursorWorldPosition(){
+   //GLFW cuenta desde arriba a la izquierda y la camara desde abajo a la izquierda
+   double x, y;
+   glfwGetCursorPos(_window, &x, &y);
+   return camera.screenToWorld().transformPoint(glm::vec2(float(x), float(w_heigth) - float(y)));
+}
+
+Tilemap* Engine::addTilemap(uint32_t width, uint32_t height, float tileSize, glm::vec2 origin){
+   editing_sprites = true;
+   Tilemap* tilemap = new Tilemap(width, height, tileSize, origin);
+   tilemaps.push_back(tilemap);
+   editing_sprites = false;
+
+   return tilemap;
+}
+
+void Engine::removeTilemap(Tilemap* tilemap){
+   std::vector<Tilemap*>::iterator found = std::find(tilemaps.begin(), tilemaps.end(), tilemap);
+   if (found == tilemaps.end())
+      return;
+
+   editing_sprites = true;
+   tilemaps.erase(found);
+   tilemapRenderer->forget(*tilemap);
+   delete tilemap;
+   editing_sprites = false;
+}
+
+//quitar un sprite y eliminarlo, no hace nada si ya se habia quitado
+//Suelta la referencia del sprite a su textura
+void Engine::removeSprite(SpriteHandle sprite){
+   if (!sprites.contains(sprite))
+      return;
+
+   unsigned int texture = sprites.getTexture(sprite);
+
+   editing_sprites = true;
+   sprites.remove(sprite);
+   editing_sprites = false;
+
+   textures.release(textures.find(texture));
 };
 
 //Parar el engine
@@ -194,64 +360,84 @@ void Engine::stopEngine(){
    pauseEngine();
    glfwSetWindowShouldClose(_window, true);
 
-   if (sprites.size() > 0){
-      for (Sprite* sprite : sprites)
-      {
-         delete sprite;
-      }
+   sprites.clear();
+
+   for (Text* text : texts)
+   {
+      delete text;
    }
+   texts.clear();
+
+   delete spriteRenderer;
+   spriteRenderer = nullptr;
+
+   delete tilemapRenderer;
+   tilemapRenderer = nullptr;
+   for (Tilemap* tilemap : tilemaps)
+      delete tilemap;
+   tilemaps.clear();
+
+   //Los shaders son compartidos, se borran cuando ya no queda nadie que los use
+   std::cout << "Shader permutations: " << Shader::permutationCount() << std::endl;
+   Shader::clearPermutations();
+
+   assetWatcher.stop();
+
+   textures.release(bitmapFont);
+   bitmapFont = TextureHandle();
+
+   std::cout << "Textures: " << textures.size() << ", " << textures.residentBytes() / 1024 << " KiB" << std::endl;
+   textures.clear();
+
+   glDeleteBuffers(1, &projectionUBO);
+   glDeleteBuffers(1, &screenUBO);
+   projectionUBO = 0;
+   screenUBO = 0;
+
+   if (ProgramCache::enabled())
+      std::cout << "Shader cache: " << ProgramCache::hits() << " hits, " << ProgramCache::misses() << " misses" << std::endl;
 
    glfwTerminate();
 };
 
-//Crea una texutura
-unsigned int Engine::createRGBATexture(std::string pathToTexture)
+//Crea una texutura, es del engine hasta stopEngine (dos peticiones de la misma imagen dan la misma textura)
+unsigned int Engine::createRGBATexture(std::string textureName)
 {
-   int texWidth, texHeight, nrChannels;
-   stbi_set_flip_vertically_on_load(true);
-   unsigned char *data = stbi_load(pathToTexture.c_str(), &texWidth, &texHeight, &nrChannels, 0);
-
-   unsigned int texture = 0; 
-   glGenTextures(1, &texture);
-    
-   glBindTexture(GL_TEXTURE_2D, texture);
-
-   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texWidth, texHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-   
-   glGenerateMipmap(GL_TEXTURE_2D);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-   stbi_image_free(data);
-
-   return texture;
+   return textures.glTexture(textures.load(textureName, TextureOptions{ textureRGBA }));
 }
 
 //Crea una texutura
-unsigned int Engine::createRGBTexture(std::string pathToTexture)
+unsigned int Engine::createRGBTexture(std::string textureName)
 {
-   int texWidth, texHeight, nrChannels;
-   stbi_set_flip_vertically_on_load(true);
-   unsigned char *data = stbi_load(pathToTexture.c_str(), &texWidth, &texHeight, &nrChannels, 0);
-
-   unsigned int texture = 0; 
-   glGenTextures(1, &texture);
-    
-   glBindTexture(GL_TEXTURE_2D, texture);
-
-   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texWidth, texHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-   
-   glGenerateMipmap(GL_TEXTURE_2D);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+   return textures.glTexture(textures.load(textureName, TextureOptions{ textureRGB }));
+}
+
+//Empieza a vigilar la carpeta de assets, los cambios se aplican al principio del siguiente frame
+//Las texturas cargadas despues ya no se comparten por contenido, asi cada archivo se recarga solo en sus sprites
+void Engine::enableHotReload(){
+   textures.setShareContent(false);
+   if (!assetWatcher.start(Asset::loosePath("")))
+      std::cout << "No se pueden vigilar los assets en " << Asset::loosePath("") << std::endl;
+}
 
-   stbi_image_free(data);
+//En el hilo de OpenGL: recarga los shaders y texturas que usan los archivos cambiados
+//Los ids de las texturas y los objetos Shader no cambian, si algo no carga se queda la version anterior
+void Engine::reloadChangedAssets(){
+   if (!assetWatcher.takeChanges(changedAssets))
+      return;
+
+   for (const std::string& name : changedAssets){
+      bool used = false;
+
+      if (Shader::reloadUsing(name))
+         used = true;
 
-   return texture;
+      if (textures.reload(name))
+         used = true;
+
+      if (used)
+         std::cout << "Recargado " << name << std::endl;
+   }
 }
 
 //Añade una funcion al call back del input
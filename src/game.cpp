@@ -5,238 +5,212 @@
 #include "include/piece.h"
 #include "include/rendering/stb_image.h"
 #include "include/rendering/text.h"
-#include "include/rendering/tileSprite.h"
-#include "include/board.h"
+#include "include/simulation.h"
+#include "include/startupTrace.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
 #include <chrono>
 #include <ostream>
+#include <random>
 #include <string>
 #include <thread>
 #include <vector>
 #include "include/movingPiece.h"
 
 //Crear el juego
-Game::Game(Engine* mainEngine): textRenderer(mainEngine->addText("0", 25, 750, 40)){
+Game::Game(Engine* mainEngine): simulation(std::random_device()()), textRenderer(mainEngine->addText("0", 25, 750, 40)){
    //Inicializa las variables necesarias
    engine = mainEngine;
-   board = Board();
-   staticPieces = std::vector<StaticPiece>();
 
    engine->addUpdateCallBack(this);
    engine->addInputCallBack(this);
 
+   startState = simulation.save();
+
    //Crea las texturas
-   std::string pathToTextures[]{
-      "../assets/textures/emptyTile.png", 
-      "../assets/textures/redTile.png", 
-      "../assets/textures/magentaTile.png", 
-      "../assets/textures/yellowTile.png",
-      "../assets/textures/cyanTile.png"
+   std::string textureNames[]{
+      "textures/emptyTile.png", 
+      "textures/redTile.png", 
+      "textures/magentaTile.png", 
+      "textures/yellowTile.png",
+      "textures/cyanTile.png"
    };
 
-   //Crea las texturas
+   //Inizializa el tablero, tiles de 40 pixeles centrado en x y pegado abajo
+   tiles = engine->addTilemap(10, 20, 40, glm::vec2(200, 0));
+   tiles->fill(empty);
+
+   //Crea las texturas, el indice de cada color en la paleta es el propio color
    for (int i = 0; i < 5; i++)
    {
-      texutres[i] = engine->createRGBATexture(pathToTextures[i]);
+      tiles->setPalette(uint16_t(i), engine->createRGBATexture(textureNames[i]));
+      StartupPhase phase("sleep");
       std::this_thread::sleep_for(std::chrono::milliseconds(5));
    }
 
-   //Inizializa el tablero
-   for (int i = 0; i < 10; i++){
-      for (int j = 0; j < 20; j++){
-         tiles[i][j] = new TileSprite(texutres[board.pieces[i][j].color], 420 - (5*40) + (i * 40), 780  - (j * 40), 40, 40);
-         std::this_thread::sleep_for(std::chrono::milliseconds(1));
-         engine->addSprite(tiles[i][j]);
-      }
-   }
-
-   movingPiece = new MovingPiece();
-   points = 0;
+   tiles->setPalette(ghostTile, engine->createRGBATexture("textures/ghostTile.png"));
 };
 
+//Con las coordenadas del Board, la fila 0 es la de arriba
+void Game::setTile(int x, int y, uint16_t tile){
+   tiles->setTile(uint32_t(x), uint32_t(19 - y), tile);
+}
+
 //funcion update, gracias al estar en el call back se ejecuta cada "tick" del juego
 void Game::update(){
-   timeToPass = 0.25;
-   //limpa las pieces
+   //Avanza la simulacion los ticks que tocan segun el tiempo real
+   double now = glfwGetTime();
+   if (lastTime == 0)
+      lastTime = now;
+
+   int ticksToRun = int((now - lastTime) * Simulation::tickRate);
+   lastTime += double(ticksToRun) / Simulation::tickRate;
+
+   //Si el juego se ha quedado parado mucho tiempo no se intenta recuperar todo de golpe
+   if (ticksToRun > Simulation::tickRate / 4){
+      ticksToRun = Simulation::tickRate / 4;
+      lastTime = now;
+   }
+
+   if (retryRequested)
+      retry();
+
+   for (int i = 0; i < ticksToRun; i++){
+      if (inputSource != nullptr)
+         inputToProcess = inputSource->nextInput(simulation);
+
+      if (recorder != nullptr)
+         recorder->record(simulation.state.ticks, inputToProcess);
+
+      simulation.tick(inputToProcess);
+      inputToProcess = inputNone;
+   }
+
+   if (simulation.state.isOver || (replay != nullptr && replay->finished(simulation)))
+      gameOver();
+
+   MovingPiece& movingPiece = simulation.state.movingPiece;
+   Board& board = simulation.state.board;
+
+   //Calcula donde caeria la pieza para dibujar la sombra
+   int ghostY = board.dropRow(movingPiece.currentX, movingPiece.currentY, movingPiece.shape, movingPiece.size);
+
+   //El tablero se compone aqui y se pasa al tilemap al final, asi un tile que acaba igual no cuenta como cambio
+   //y el chunk solo se vuelve a subir cuando algo se ha movido
+   uint16_t cells[10][20];
    for (int i = 0; i < 10; i++){
       for (int j = 0; j < 20; j++){
-         board.pieces[i][j].color = empty;
+         cells[i][j] = board.pieces[i][j].color; 
       }
    }
-   
-   //Dibujar las piezas estaticas
-   for(int i = 0; i < staticPieces.size(); i++){
-      board.pieces[staticPieces[i].x][staticPieces[i].y].color = staticPieces[i].color;
-   }
-   
-   //procesa el input
-   switch (keyToProcess) {
-      case GLFW_KEY_A:
-         if (isValidMove(movingPiece->currentX - 1, movingPiece->currentY, movingPiece->currentStruct))
-            movingPiece->moveLeft();
-      break;
-      case GLFW_KEY_SPACE:
-         movingPiece->rotateLeft(board.pieces);
-      break;
-      case GLFW_KEY_D:
-         if (isValidMove(movingPiece->currentX + 1, movingPiece->currentY, movingPiece->currentStruct))
-            movingPiece->moveRigth();
-      break;
-      case GLFW_KEY_S:
-         timeToPass = 0.015;
-      break;
-   }
-   keyToProcess = 0;
 
-   //El bucle de movimiento
-   if ((glfwGetTime() - lastTime) >= timeToPass) {
-      movePiece();
+   //Dibuja la sombra y despues la pieza que se mueve por encima
+   for (int i = 0; i < movingPiece.size; i++){
+      for (int j = 0; j < movingPiece.size; j++){
+         if (movingPiece.cell(i, j)){
+            int x = movingPiece.currentX + i;
 
-      lastTime = glfwGetTime();
+            if (board.pieces[x][ghostY + j].color == empty)
+               cells[x][ghostY + j] = ghostTile;
+         }
+      }
    }
 
-   //Establecer las casillas de la pieza
-   for (int i = 0; i < movingPiece->currentStruct.size(); i++){
-      for (int j = 0; j < movingPiece->currentStruct[i].size(); j++){
-         if (movingPiece->currentStruct[i][j] == 1){
-            board.pieces[movingPiece->currentX + i][movingPiece->currentY + j].color = movingPiece->color;
+   for (int i = 0; i < movingPiece.size; i++){
+      for (int j = 0; j < movingPiece.size; j++){
+         if (movingPiece.cell(i, j)){
+            cells[movingPiece.currentX + i][movingPiece.currentY + j] = movingPiece.color;
          }
       }
    }
-      
-   //Actualiza las texutras
+
    for (int i = 0; i < 10; i++){
       for (int j = 0; j < 20; j++){
-         tiles[i][j]->setTexutre(texutres[board.pieces[i][j].color]); 
+         setTile(i, j, cells[i][j]);
       }
    }
 
-   textRenderer->setText(std::to_string(points));
+   textRenderer->setNumber(simulation.state.points);
 };
 
 //Guarda el input
 void Game::processInput(int key){
-   keyToProcess = key;
-};
-
-//Mueve la pieza hacia abajo
-void Game::movePiece(){
-   //Baja la pieza una casilla
-   movingPiece->currentY++;
-   
-   //Comprobar si hay que hacer estatica la pieza
-   for (int j = 0; j < movingPiece->currentStruct.size(); j++){
-     for (int i = 0; i < movingPiece->currentStruct.size(); i++){
-        if ( movingPiece->currentStruct[i][j] == 1){
-           if(board.pieces[movingPiece->currentX + i][movingPiece->currentY + j + 1].color != empty){
-               placePiece();
-               return;
-           }else if (movingPiece->currentY + j + 1 >= 20){
-               placePiece();
-               return;
-           }
-        }
-     }
-   }
-}
-
-//Poner una pieza en su lugar
-void Game::placePiece(){
-   //Detectar si has perdido
-   if (movingPiece->currentY <= movingPiece->currentStruct.size()){
-      gameOver();
-      return;
+   switch (key) {
+      case GLFW_KEY_A:
+         inputToProcess = inputLeft;
+      break;
+      case GLFW_KEY_D:
+         inputToProcess = inputRight;
+      break;
+      case GLFW_KEY_SPACE:
+         inputToProcess = inputRotate;
+      break;
+      case GLFW_KEY_S:
+         inputToProcess = inputSoftDrop;
+      break;
+      case GLFW_KEY_W:
+         inputToProcess = inputHardDrop;
+      break;
+      case GLFW_KEY_R:
+         retryRequested = true;
+      break;
    }
+};
 
-   //Añadir piezas estaticas
-   for (int i = 0; i < movingPiece->currentStruct.size(); i++){
-      for (int j = 0; j < movingPiece->currentStruct[i].size(); j++){
-         if (movingPiece->currentStruct[i][j] == 1){
-            staticPieces.push_back(StaticPiece(movingPiece->currentX + i,movingPiece->currentY + j, movingPiece->color));
-         }
-      }
-   }
+void Game::gameOver(){
+   engine->pauseEngine();
 
-   //Dibuja las piezas estaticas
-   for(int i = 0; i < staticPieces.size(); i++){
-      board.pieces[staticPieces[i].x][staticPieces[i].y].color = staticPieces[i].color;
-   }
+   stopRecording();
 
-   //Comprobar eliminar piezas 
-   for (int j = 0; j < 20; j++){
-      bool hasToDelete = true;
-      for(int i = 1; i < 10; i++){
-         if (board.pieces[i][j].color == empty){
-            hasToDelete = false;
-            break;
-         }
-      }
-
-      if (hasToDelete){
-         deleteRow(j);
-         points += 5;
-      }
+   if (replay != nullptr){
+      replay->rewind();
+      simulation.reset(replay->seed);
+   }else{
+      simulation.reset(std::random_device()());
    }
+   startState = simulation.save();
 
-   delete movingPiece;
-   movingPiece = new MovingPiece();
+   engine->resumeEngine();
 }
 
-//Delete a row
-void Game::deleteRow(int column){
-   std::vector<int> elementsToRemove = std::vector<int>();
-   for (int i = 0; i < 10; i++){
-      for(int a = 0; a < staticPieces.size(); a++){
-         if (staticPieces[a].x == i && staticPieces[a].y == column){
-            staticPieces.erase(staticPieces.begin() + a);
-         }
-      }
-   }
+//Vuelve al principio de la partida actual, con las mismas piezas
+void Game::retry(){
+   retryRequested = false;
+   simulation.restore(startState);
 
-   for(int a = 0; a < staticPieces.size(); a++){
-      if (staticPieces[a].y <= column)
-         staticPieces[a].y++;
-   }
+   if (replay != nullptr)
+      replay->rewind();
+   if (recorder != nullptr)
+      recorder->start(simulation.state.seed);
 }
 
-bool Game::isValidMove(int newX, int newY, std::vector<std::vector<int>>& structure){
-   for(int i = 0; i < structure.size(); i++){
-      for (int j = 0; j < structure.size(); j++){
-         if (structure[i][j] == 1){
-            if (newX + i > 9 || newX + i < 0){
-               return false;
-            }
-
-            if (board.pieces[newX + i][newY + j].color != empty){
-               return false;
-            }
-         }
-      }
-   }
-   
-   return true;
+void Game::startRecording(ReplayRecorder* newRecorder){
+   recorder = newRecorder;
+   recorder->start(simulation.state.seed);
 }
 
-void Game::gameOver(){
-   engine->pauseEngine();
+//Termina la grabacion y la escribe en el archivo
+void Game::stopRecording(){
+   if (recorder == nullptr)
+      return;
 
-   //Dibujar las piezas estaticas
-   staticPieces.clear(); 
+   if (!recorder->finish(simulation))
+      std::cout << "Failed to save the replay" << std::endl;
 
-   //limpa las pieces
-   for (int i = 0; i < 10; i++){
-      for (int j = 0; j < 20; j++){
-         board.pieces[i][j].color = empty;
-      }
-   }
+   recorder = nullptr;
+}
 
-   delete movingPiece;
-   movingPiece = new MovingPiece();
+void Game::playReplay(ReplayPlayer* player){
+   replay = player;
+   inputSource = player;
 
-   points = 0;
+   replay->rewind();
+   simulation.reset(replay->seed);
+   startState = simulation.save();
 
-   engine->resumeEngine();
+   //Si ya se estaba grabando (--record antes de --replay) la grabacion empieza otra vez con la semilla de la repeticion
+   if (recorder != nullptr)
+      recorder->start(simulation.state.seed);
 }
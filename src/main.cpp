@@ -1,21 +1,76 @@
+#include <cstdlib>
 #include <iostream>
 #include <stdio.h>
 #include <string>
 #include <thread>
 
+#include "include/allocTracker.h"
 #include "include/engine.h"
-#include "include/rendering/sprite.h"
 #include "include/game.h"
+#include "include/bot.h"
+#include "include/replay.h"
+#include "include/startupTrace.h"
 
 #include "include/myLibs/hashMap.h"
 
-int main(){
+int main(int argc, char** argv){
+   StartupTrace::start();
+
+   //Tiene que estar activo antes de crear el engine
+   for (int i = 1; i + 1 < argc; i++){
+      if (std::string(argv[i]) == "--startup-trace")
+         StartupTrace::enable(argv[i + 1]);
+   }
+
+   StartupPhase enginePhase("engine");
    Engine engine(800, 800);
+   enginePhase.end();
+
+   //Antes de que el juego cargue las texturas, con la recarga activa no se comparten entre nombres
+   for (int i = 1; i < argc; i++){
+      if (std::string(argv[i]) == "--hot-reload")
+         engine.enableHotReload();
+   }
  
+   StartupPhase gamePhase("game");
    Game game(&engine);
+   gamePhase.end();
+
+   Bot bot;
+   ReplayRecorder recorder("");
+   ReplayPlayer player;
+
+   for (int i = 1; i < argc; i++){
+      std::string arg = argv[i];
+
+      //Modo demo: juega el bot
+      if (arg == "--attract"){
+         game.setInputSource(&bot);
+      }else if (arg == "--record" && i + 1 < argc){
+         recorder = ReplayRecorder(argv[++i]);
+         game.startRecording(&recorder);
+      }else if (arg == "--replay" && i + 1 < argc){
+         if (!player.load(argv[++i])){
+            std::cout << "Invalid replay " << argv[i] << std::endl;
+            return 1;
+         }
+         game.playReplay(&player);
+      }else if (arg == "--startup-trace" && i + 1 < argc){
+         //Ya se ha leido antes de crear el engine
+         i++;
+      }else if (arg == "--hot-reload"){
+         //Recarga shaders y texturas al guardarlos en la carpeta assets, ya se ha activado antes de crear el juego
+      }else if ((arg == "--alloc-budget" || arg == "--alloc-assert") && i + 1 < argc){
+         //Maximo de reservas por frame, solo si se ha compilado con TETRIS_TRACK_ALLOCATIONS
+         BUDGET_ACTION action = arg == "--alloc-assert" ? budgetAssert : budgetLog;
+         AllocTracker::setBudget(std::strtoull(argv[++i], nullptr, 10), 0, action);
+      }
+   }
 
    std::thread mainthread(&Engine::Init, &engine);
 
    mainthread.join();
+
+   game.stopRecording();
    return 0;
 }
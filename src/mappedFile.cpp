@@ -0,0 +1,59 @@
+#include "include/mappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(MappedFile&& other): bytes(other.bytes), length(other.length){
+   other.bytes = nullptr;
+   other.length = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other){
+   if (this != &other){
+      close();
+      bytes = other.bytes;
+      length = other.length;
+      other.bytes = nullptr;
+      other.length = 0;
+   }
+
+   return *this;
+}
+
+bool MappedFile::open(const std::string& path){
+   close();
+
+   int descriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (descriptor < 0)
+      return false;
+
+   struct stat info;
+   if (fstat(descriptor, &info) != 0 || info.st_size <= 0){
+      ::close(descriptor);
+      return false;
+   }
+
+   void* mapping = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+   //La proyeccion sigue valida despues de cerrar el descriptor
+   ::close(descriptor);
+   if (mapping == MAP_FAILED)
+      return false;
+
+   //Se va a leer entero y en orden, que el kernel lo vaya trayendo por adelantado
+   madvise(mapping, size_t(info.st_size), MADV_SEQUENTIAL);
+   madvise(mapping, size_t(info.st_size), MADV_WILLNEED);
+
+   bytes = (const uint8_t*)mapping;
+   length = size_t(info.st_size);
+   return true;
+}
+
+void MappedFile::close(){
+   if (bytes != nullptr)
+      munmap((void*)bytes, length);
+
+   bytes = nullptr;
+   length = 0;
+}
@@ -1,14 +1,7 @@
 #include "include/movingPiece.h"
-#include "include/game.h"
 #include "include/piece.h"
-#include <chrono>
-#include <cmath>
+#include <cstdint>
 #include <iostream>
-#include <random>
-#include <thread>
-#include <utility>
-#include <vector>
-#include "include/piece.h"
 
 const int ISTRUCT[4][4] =
    {  
@@ -59,221 +52,89 @@ const int SSTRUCT[3][3] =
       {0,1,1},
    };
 
-bool canRotate = true;
-bool canLeft = true;
-bool canRigth = true;
-bool canGoDown = true;
-
-MovingPiece::MovingPiece(){
-   std::random_device rd;
-   std::mt19937 gen(rd());
-
-   std::uniform_int_distribution<int> structRandom(0, 6);  
-
-   int structToUse = structRandom(gen);
-
-   switch (structToUse) {
-     case 0:
-        currentStruct.resize(4, std::vector<int>(4, 0));
-        for (int i = 0; i < 4; i++){
-           for (int j = 0; j < 4; j++){
-              currentStruct[i][j] = ISTRUCT[i][j];
-           }
-        }
-     break;
-     case 1:
-        currentStruct.resize(2, std::vector<int>(2, 0));
-        for (int i = 0; i < 2; i++){
-           for (int j = 0; j < 2; j++){
-              currentStruct[i][j] = OSTRUCT[i][j];
-           }
-        }
-     break;
-     case 2:
-        currentStruct.resize(3, std::vector<int>(3, 0));
-        for (int i = 0; i < 3; i++){
-           for (int j = 0; j < 3; j++){
-              currentStruct[i][j] = TSTRUCT[i][j];
-           }
-        }
-     break;
-     case 3:
-        currentStruct.resize(3, std::vector<int>(3, 0));
-        for (int i = 0; i < 3; i++){
-           for (int j = 0; j < 3; j++){
-              currentStruct[i][j] = LSTRUCT[i][j];
-           }
-        }
-     break;
-     case 4:
-        currentStruct.resize(3, std::vector<int>(3, 0));
-        for (int i = 0; i < 3; i++){
-           for (int j = 0; j < 3; j++){
-              currentStruct[i][j] = JSTRUCT[i][j];
-           }
-        }
-     break;
-     case 5:
-        currentStruct.resize(3, std::vector<int>(3, 0));
-        for (int i = 0; i < 3; i++){
-           for (int j = 0; j < 3; j++){
-              currentStruct[i][j] = ZSTRUCT[i][j];
-           }
-        }
-     break;
-     case 6:
-        currentStruct.resize(3, std::vector<int>(3, 0));
-        for (int i = 0; i < 3; i++){
-           for (int j = 0; j < 3; j++){
-              currentStruct[i][j] = SSTRUCT[i][j];
-           }
-        }
-     break;
+//Empaqueta una estructura NxN en 16 bits: la casilla (i, j) es el bit i + 4 * j
+template<int N>
+constexpr uint16_t packStruct(const int (&structure)[N][N]){
+   uint16_t shape = 0;
+   for (int i = 0; i < N; i++){
+      for (int j = 0; j < N; j++){
+         if (structure[i][j] == 1)
+            shape |= uint16_t(1 << (i + 4 * j));
+      }
    }
+   return shape;
+}
 
-   currentX = 5 - (currentStruct.size()/2);
-   currentY = 0;
-
-   std::uniform_int_distribution<int> colorRandom(1, 4);  
+const uint16_t SHAPES[7] = {
+   packStruct(ISTRUCT),
+   packStruct(OSTRUCT),
+   packStruct(TSTRUCT),
+   packStruct(LSTRUCT),
+   packStruct(JSTRUCT),
+   packStruct(ZSTRUCT),
+   packStruct(SSTRUCT),
+};
 
-   int theColor = colorRandom(gen);
+const int SIZES[7] = { 4, 2, 3, 3, 3, 3, 3 };
 
-   switch (theColor){
-      case red:
-         color = red;
-      break;
-      case magenta:
-         color = magenta;
-      break;
-      case yellow:
-         color = yellow;
-      break;
-      case cyan:
-         color = cyan;
-      break;
-   }
+MovingPiece::MovingPiece(): currentX(0), currentY(0), shape(0), size(0), color(empty){
 }
 
-void MovingPiece::rotateLeft(Piece currentBoard[10][20]){
-   if (!canRotate)
-      return;
+MovingPiece::MovingPiece(Random& random){
+   int structToUse = random.range(0, 6);
 
-   float magicNumber = (currentStruct.size() - 1.0f) / 2.0f;
-   std::vector<std::pair<float, float>> currentPositions;
-   for (int i = 0; i < currentStruct.size(); ++i) {
-       for (int j = 0; j < currentStruct.size(); ++j) {
-         if (currentStruct[i][j]){
-            currentPositions.push_back(std::make_pair(i - magicNumber, (j - magicNumber)));
-         }
-       }
-   }
+   shape = SHAPES[structToUse];
+   size = SIZES[structToUse];
 
-   std::vector<std::pair<float, float>> newPositions;
-   for (int i = 0; i < currentPositions.size(); ++i){
-      float x = currentPositions[i].first * std::cos(3.14159 / 2) - currentPositions[i].second * std::sin(3.14159 / 2);
-      float y = currentPositions[i].first * std::sin(3.14159 / 2) + currentPositions[i].second * std::cos(3.14159 / 2);
-      newPositions.push_back(std::make_pair(x, y)); 
-   }
+   currentX = 5 - (size/2);
+   currentY = 0;
+
+   color = COLOR(random.range(red, cyan));
+}
 
-   //Comprobar que se pude rotar   std::round(newPositions[i].first + magicNumber)   std::round(newPositions[i].second + magicNumber)
-   for (int i = 0; i < newPositions.size(); ++i){
-      if(currentBoard[int(currentX + std::round(newPositions[i].first + magicNumber))][int(currentY + std::round(newPositions[i].second + magicNumber))].color != empty){
-         return;
-      } 
-      if (currentX + std::round(newPositions[i].first + magicNumber) > 9  || currentX  < 0){
-         std::cout << "a" << std::endl;
-         return;
+//Rota la pieza, devuelve false si no cabe en el tablero
+bool MovingPiece::rotateLeft(Piece currentBoard[10][20]){
+   //Giro de 90 grados dentro del cuadrado de la pieza: la casilla (i, j) pasa a (size - 1 - j, i)
+   uint16_t rotated = 0;
+   for (int i = 0; i < size; i++){
+      for (int j = 0; j < size; j++){
+         if (cell(i, j))
+            rotated |= uint16_t(1 << ((size - 1 - j) + 4 * i));
       }
    }
 
-   for (int i = 0; i < currentStruct.size(); ++i) {
-       for (int j = 0; j < currentStruct.size(); ++j) {
-         currentStruct[i][j] = 0;
-       }
-   } 
+   //Comprobar que se pude rotar, primero los limites y despues las casillas ocupadas
+   for (int i = 0; i < size; i++){
+      for (int j = 0; j < size; j++){
+         if (!(rotated & (1 << (i + 4 * j))))
+            continue;
+
+         int x = currentX + i;
+         int y = currentY + j;
 
-   for (int i = 0; i < newPositions.size(); ++i){
-      currentStruct[int (std::round(newPositions[i].first + magicNumber))][int (std::round(newPositions[i].second + magicNumber))] = 1; 
+         if (x > 9 || x < 0 || y > 19 || y < 0){
+            return false;
+         }
+         if(currentBoard[x][y].color != empty){
+            return false;
+         } 
+      }
    }
 
-   canRotate = false;
-   auto stablishCanRotate = [](){
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+   shape = rotated;
 
-      canRotate = true;
-   };
-   std::thread tarea(stablishCanRotate);
-   tarea.detach();
+   return true;
 }
 
 void MovingPiece::moveRigth(){
-   if (!canRigth)
-      return;
-
    currentX++;
-
-   canRigth = false;
-   auto stablishCanRigth = [](){
-      std::this_thread::sleep_for(std::chrono::milliseconds(70));
-
-      canRigth = true; 
-   };
-   std::thread tarea(stablishCanRigth);
-   tarea.detach();
 }
 
 void MovingPiece::moveLeft(){
-   if (!canLeft)
-      return;
-
    currentX--;
-
-   canLeft = false;
-   auto stablishCanLeft = [](){
-      std::this_thread::sleep_for(std::chrono::milliseconds(70));
-
-      canLeft = true; 
-   };
-   std::thread tarea(stablishCanLeft);
-   tarea.detach();
 }
 
-bool MovingPiece::moveDown(Board *board){
-   if (!canGoDown)
-      return false;
-
-   canGoDown = false;
-
-   auto stablishCanDown = [](){
-      std::this_thread::sleep_for(std::chrono::milliseconds(200));
-
-      canGoDown = true; 
-   };
-
-   while (true){
-      currentY++;
-
-      for (int j = 0; j < currentStruct.size(); j++){
-        for (int i = 0; i < currentStruct.size(); i++){
-           if (currentStruct[i][j] == 1){
-              if(board->pieces[currentX + i][currentY + j + 1].color != empty){
-                  std::thread tarea(stablishCanDown);
-                  tarea.detach();
-
-                  return true;
-              }else if (currentY + j + 1 >= 20){
-                  std::thread tarea(stablishCanDown);
-                  tarea.detach();
-
-                  return true;
-              }
-           }
-        }
-      }
-   }
-
-   return false;
-
-   std::thread tarea(stablishCanDown);
-   tarea.detach();
+//Deja caer la pieza hasta la fila en la que se quedaria
+void MovingPiece::moveDown(Board *board){
+   currentY = board->dropRow(currentX, currentY, shape, size);
 }
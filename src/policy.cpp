@@ -0,0 +1,29 @@
+#include "include/policy.h"
+#include "include/simulation.h"
+
+INPUT RandomPolicy::nextInput(const Simulation&){
+   return INPUT(random.range(inputNone, inputHardDrop));
+}
+
+INPUT ScriptedPolicy::nextInput(const Simulation&){
+   if (script.empty())
+      return inputNone;
+
+   char action = script[index];
+   index = (index + 1) % script.size();
+
+   switch (action) {
+      case 'L':
+         return inputLeft;
+      case 'R':
+         return inputRight;
+      case 'U':
+         return inputRotate;
+      case 'D':
+         return inputSoftDrop;
+      case 'H':
+         return inputHardDrop;
+   }
+
+   return inputNone;
+}
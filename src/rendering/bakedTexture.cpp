@@ -0,0 +1,151 @@
+#include "include/rendering/bakedTexture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+static uint32_t mipSize(uint32_t size, uint32_t level){
+   uint32_t result = size >> level;
+   return result > 0 ? result : 1;
+}
+
+static size_t levelBytes(uint32_t width, uint32_t height, uint32_t level){
+   return size_t(mipSize(width, level)) * mipSize(height, level) * 4;
+}
+
+//Niveles hasta llegar a 1x1
+static uint32_t fullMipCount(uint32_t width, uint32_t height){
+   uint32_t count = 1;
+   while ((width > 1 || height > 1) && count < MAX_BAKED_MIPS){
+      width = width > 1 ? width / 2 : 1;
+      height = height > 1 ? height / 2 : 1;
+      count++;
+   }
+
+   return count;
+}
+
+//Media de cada bloque de 2x2, si el nivel anterior tiene tamaño impar la ultima fila o columna se repite
+static void downsample(const uint8_t* source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t* destination, uint32_t width, uint32_t height){
+   for (uint32_t y = 0; y < height; y++){
+      uint32_t y0 = std::min(y * 2, sourceHeight - 1);
+      uint32_t y1 = std::min(y * 2 + 1, sourceHeight - 1);
+
+      for (uint32_t x = 0; x < width; x++){
+         uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+         uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+
+         for (int channel = 0; channel < 4; channel++){
+            uint32_t sum = source[(size_t(y0) * sourceWidth + x0) * 4 + channel] + source[(size_t(y0) * sourceWidth + x1) * 4 + channel] +
+                           source[(size_t(y1) * sourceWidth + x0) * 4 + channel] + source[(size_t(y1) * sourceWidth + x1) * 4 + channel];
+            destination[(size_t(y) * width + x) * 4 + channel] = uint8_t((sum + 2) / 4);
+         }
+      }
+   }
+}
+
+std::string bakedTexturePath(const std::string& imagePath){
+   size_t dot = imagePath.find_last_of('.');
+   size_t slash = imagePath.find_last_of('/');
+   if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+      return imagePath + ".tex";
+
+   return imagePath.substr(0, dot) + ".tex";
+}
+
+bool bakedTextureIsCurrent(const std::string& imagePath, const std::string& bakedPath){
+   std::error_code error;
+   std::filesystem::file_time_type baked = std::filesystem::last_write_time(bakedPath, error);
+   if (error)
+      return false;
+
+   std::filesystem::file_time_type image = std::filesystem::last_write_time(imagePath, error);
+   return error || baked >= image;
+}
+
+std::vector<uint8_t> bakeTexture(const uint8_t* pixels, uint32_t width, uint32_t height, bool withMips){
+   if (width == 0 || height == 0)
+      return std::vector<uint8_t>();
+
+   BakedTextureHeader header = {};
+   memcpy(header.magic, "TTEX", 4);
+   header.version = BAKED_TEXTURE_VERSION;
+   header.width = width;
+   header.height = height;
+   header.mipCount = withMips ? fullMipCount(width, height) : 1;
+
+   size_t total = sizeof(header);
+   for (uint32_t level = 0; level < header.mipCount; level++)
+      total += levelBytes(width, height, level);
+
+   std::vector<uint8_t> result(total);
+   memcpy(result.data(), &header, sizeof(header));
+   memcpy(result.data() + sizeof(header), pixels, levelBytes(width, height, 0));
+
+   //Cada nivel se calcula a partir del anterior, que ya esta en result
+   size_t previous = sizeof(header);
+   for (uint32_t level = 1; level < header.mipCount; level++){
+      size_t current = previous + levelBytes(width, height, level - 1);
+      downsample(result.data() + previous, mipSize(width, level - 1), mipSize(height, level - 1), result.data() + current, mipSize(width, level), mipSize(height, level));
+      previous = current;
+   }
+
+   return result;
+}
+
+bool writeBakedTexture(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, bool withMips){
+   std::vector<uint8_t> baked = bakeTexture(pixels, width, height, withMips);
+   if (baked.empty())
+      return false;
+
+   std::ofstream file(path, std::ios::binary);
+   if (!file)
+      return false;
+
+   file.write((const char*)baked.data(), baked.size());
+   return bool(file);
+}
+
+bool BakedTexture::load(const std::string& path){
+   header = nullptr;
+   if (!file.open(path))
+      return false;
+
+   return parse(file.data(), file.size());
+}
+
+bool BakedTexture::parse(const uint8_t* data, size_t size){
+   header = nullptr;
+   if (size < sizeof(BakedTextureHeader))
+      return false;
+
+   const BakedTextureHeader* candidate = (const BakedTextureHeader*)data;
+   if (memcmp(candidate->magic, "TTEX", 4) != 0 || candidate->version != BAKED_TEXTURE_VERSION)
+      return false;
+
+   if (candidate->width == 0 || candidate->height == 0 || candidate->mipCount == 0 || candidate->mipCount > fullMipCount(candidate->width, candidate->height))
+      return false;
+
+   //Los niveles van seguidos, el archivo tiene que medir justo la suma
+   size_t offset = sizeof(BakedTextureHeader);
+   for (uint32_t level = 0; level < candidate->mipCount; level++){
+      levels[level] = data + offset;
+      offset += levelBytes(candidate->width, candidate->height, level);
+   }
+
+   if (offset != size)
+      return false;
+
+   header = candidate;
+   return true;
+}
+
+uint32_t BakedTexture::levelWidth(uint32_t level) const{
+   return mipSize(header->width, level);
+}
+
+uint32_t BakedTexture::levelHeight(uint32_t level) const{
+   return mipSize(header->height, level);
+}
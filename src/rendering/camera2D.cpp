@@ -0,0 +1,68 @@
+#include "include/rendering/camera2D.h"
+
+#include <algorithm>
+
+void Camera2D::setPosition(glm::vec2 newPosition){
+   followsViewport = false;
+   if (newPosition == position)
+      return;
+
+   position = newPosition;
+   revision++;
+}
+
+void Camera2D::setZoom(float newZoom){
+   if (newZoom == zoom || !(newZoom > 0))
+      return;
+
+   zoom = newZoom;
+   revision++;
+}
+
+void Camera2D::setRotation(float newRotation){
+   if (newRotation == rotation)
+      return;
+
+   rotation = newRotation;
+   revision++;
+}
+
+void Camera2D::setViewport(glm::vec2 size){
+   if (size == viewport)
+      return;
+
+   viewport = size;
+   if (followsViewport)
+      position = size * 0.5f;
+   revision++;
+}
+
+void Camera2D::centerOnViewport(){
+   setPosition(viewport * 0.5f);
+   followsViewport = true;
+}
+
+//Primero se lleva la camara al origen, se gira al reves, se escala y se mueve al centro de la ventana
+Affine2D Camera2D::worldToScreen() const{
+   float radians = rotation * 3.14159265358979323846f / 180.0f;
+
+   return Affine2D::translation(viewport * 0.5f) * Affine2D::scale(glm::vec2(zoom, zoom)) *
+          Affine2D::rotation(-std::sin(radians), std::cos(radians)) * Affine2D::translation(-position);
+}
+
+void Camera2D::visibleBounds(glm::vec2& min, glm::vec2& max) const{
+   Affine2D toWorld = screenToWorld();
+
+   glm::vec2 corners[4] = {
+      toWorld.transformPoint(glm::vec2(0, 0)),
+      toWorld.transformPoint(glm::vec2(viewport.x, 0)),
+      toWorld.transformPoint(glm::vec2(0, viewport.y)),
+      toWorld.transformPoint(viewport)
+   };
+
+   min = max = corners[0];
+   for (const glm::vec2& corner : corners){
+      min = glm::vec2(std::min(min.x, corner.x), std::min(min.y, corner.y));
+      max = glm::vec2(std::max(max.x, corner.x), std::max(max.y, corner.y));
+   }
+}
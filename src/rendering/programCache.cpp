@@ -0,0 +1,221 @@
+#include "include/rendering/programCache.h"
+#include "include/assetPack.h"
+#include "include/mappedFile.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+//No estan en el glad de 3.3
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+static GetProgramBinaryProc getProgramBinary = nullptr;
+static ProgramBinaryProc programBinary = nullptr;
+static ProgramParameteriProc programParameteri = nullptr;
+
+//Cabecera de cada binario guardado, la clave se repite dentro por si dos claves acaban en el mismo nombre
+const uint32_t PROGRAM_CACHE_VERSION = 1;
+
+struct ProgramCacheHeader{
+   char magic[4];
+   uint32_t version;
+   uint64_t key;
+   uint32_t binaryFormat;
+   uint32_t length;
+};
+static_assert(sizeof(ProgramCacheHeader) == 24, "La cabecera de la cache de shaders ocupa 24 bytes");
+
+static bool cacheEnabled = false;
+static uint64_t driverHash = 0;
+static std::string cacheDirectory;
+static unsigned int cacheHits = 0;
+static unsigned int cacheMisses = 0;
+
+//FNV-1a por partes, para no tener que juntar el codigo en una string
+static uint64_t hashBytes(uint64_t hash, std::string_view bytes){
+   for (char c : bytes){
+      hash ^= uint8_t(c);
+      hash *= 1099511628211ull;
+   }
+
+   //Separador, asi "ab" + "c" no da lo mismo que "a" + "bc"
+   hash ^= 0xFF;
+   hash *= 1099511628211ull;
+   return hash;
+}
+
+static const char* glString(GLenum name){
+   const GLubyte* value = glGetString(name);
+   return value ? (const char*)value : "";
+}
+
+static std::string hexName(uint64_t value){
+   char name[17];
+   snprintf(name, sizeof(name), "%016" PRIx64, value);
+   return name;
+}
+
+static std::string programPath(uint64_t key){
+   return cacheDirectory + hexName(key) + ".bin";
+}
+
+void ProgramCache::init(){
+   cacheEnabled = false;
+
+   getProgramBinary = (GetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+   programBinary = (ProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+   programParameteri = (ProgramParameteriProc)glfwGetProcAddress("glProgramParameteri");
+   if (!getProgramBinary || !programBinary || !programParameteri)
+      return;
+
+   //Algunos drivers tienen las funciones pero ningun formato
+   GLint formats = 0;
+   glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+   if (formats <= 0)
+      return;
+
+   driverHash = 14695981039346656037ull;
+   driverHash = hashBytes(driverHash, glString(GL_VENDOR));
+   driverHash = hashBytes(driverHash, glString(GL_RENDERER));
+   driverHash = hashBytes(driverHash, glString(GL_VERSION));
+
+   //Una carpeta por driver, las de otros drivers ya no sirven
+   std::error_code error;
+   std::filesystem::path root = executableDirectory() + "shaderCache";
+   std::string driverName = hexName(driverHash);
+   for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(root, error)){
+      if (entry.path().filename() != driverName)
+         std::filesystem::remove_all(entry.path(), error);
+   }
+
+   std::filesystem::create_directories(root / driverName, error);
+   if (error)
+      return;
+
+   cacheDirectory = (root / driverName).string() + "/";
+   cacheEnabled = true;
+}
+
+bool ProgramCache::enabled(){
+   return cacheEnabled;
+}
+
+uint64_t ProgramCache::key(std::string_view vertexSource, std::string_view fragmentSource){
+   uint64_t hash = driverHash ^ PROGRAM_CACHE_VERSION;
+   hash = hashBytes(hash, vertexSource);
+   hash = hashBytes(hash, fragmentSource);
+   return hash;
+}
+
+unsigned int ProgramCache::load(uint64_t key){
+   if (!cacheEnabled)
+      return 0;
+
+   std::string path = programPath(key);
+   MappedFile file;
+   if (!file.open(path)){
+      cacheMisses++;
+      return 0;
+   }
+
+   const ProgramCacheHeader* header = (const ProgramCacheHeader*)file.data();
+   bool valid = file.size() >= sizeof(ProgramCacheHeader) && memcmp(header->magic, "TPRG", 4) == 0 &&
+                header->version == PROGRAM_CACHE_VERSION && header->key == key && header->length == file.size() - sizeof(ProgramCacheHeader);
+
+   unsigned int program = 0;
+   if (valid){
+      program = glCreateProgram();
+      programBinary(program, header->binaryFormat, file.data() + sizeof(ProgramCacheHeader), GLsizei(header->length));
+
+      //El driver puede rechazar el binario aunque sea el mismo (por ejemplo tras actualizarse sin cambiar la version)
+      GLint linked = 0;
+      glGetProgramiv(program, GL_LINK_STATUS, &linked);
+      if (!linked){
+         glDeleteProgram(program);
+         program = 0;
+      }
+   }
+
+   if (program == 0){
+      file.close();
+      std::error_code error;
+      std::filesystem::remove(path, error);
+      cacheMisses++;
+      return 0;
+   }
+
+   cacheHits++;
+   return program;
+}
+
+void ProgramCache::prepareForStore(unsigned int program){
+   if (cacheEnabled)
+      programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::store(uint64_t key, unsigned int program){
+   if (!cacheEnabled)
+      return;
+
+   GLint length = 0;
+   glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+   if (length <= 0)
+      return;
+
+   std::vector<uint8_t> binary(static_cast<size_t>(length));
+   GLsizei written = 0;
+   GLenum format = 0;
+   getProgramBinary(program, length, &written, &format, binary.data());
+   if (written <= 0)
+      return;
+
+   ProgramCacheHeader header = {};
+   memcpy(header.magic, "TPRG", 4);
+   header.version = PROGRAM_CACHE_VERSION;
+   header.key = key;
+   header.binaryFormat = format;
+   header.length = uint32_t(written);
+
+   //Se escribe aparte y se renombra, nunca queda un binario a medias con el nombre bueno
+   std::string path = programPath(key);
+   std::string temporary = path + ".tmp";
+   bool saved;
+   {
+      std::ofstream file(temporary, std::ios::binary);
+      file.write((const char*)&header, sizeof(header));
+      file.write((const char*)binary.data(), written);
+      saved = bool(file);
+   }
+
+   std::error_code error;
+   if (saved)
+      std::filesystem::rename(temporary, path, error);
+   if (!saved || error)
+      std::filesystem::remove(temporary, error);
+}
+
+unsigned int ProgramCache::hits(){
+   return cacheHits;
+}
+
+unsigned int ProgramCache::misses(){
+   return cacheMisses;
+}
@@ -1,56 +1,36 @@
 #include <include/rendering/shader.h>
+#include "include/assetPack.h"
+#include "include/rendering/programCache.h"
+#include "include/rendering/shaderSource.h"
+#include "include/startupTrace.h"
 
 #include <glad/glad.h> 
 
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <utility>
 
 using namespace std;
 
-//Crea el shader, se debe pasar el path al vertex shader y el fragment
-Shader::Shader(const char* vertexPath, const char* fragmentPath)
+//Compila y enlaza un programa, o lo saca de la cache si ya se ha enlazado antes con este driver
+//linked es false si algo ha fallado, el programa se devuelve igualmente
+static unsigned int buildProgram(std::string_view vertexCode, std::string_view fragmentCode, bool& linked)
 {
-    //Las variables que guardan el shader
-    string vertexCode;
-    string fragmentCode;
-
-    //Las variables del lector de datos
-    ifstream vShaderFile;
-    ifstream fShaderFile;
-
-    //Permite que los ifstream objects puedan enviar excepciones
-    vShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-    fShaderFile.exceptions(ifstream::failbit | ifstream::badbit);
-
-    try
-    {
-        //abrir el archivo
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
-
-        stringstream vShaderStream, fShaderStream;
-
-        //lee los buffers y los guarda en un stream
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-
-        //cierra los "hadlers" de los archivos
-        vShaderFile.close();
-        fShaderFile.close();
-
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }catch (ifstream::failure e)
-    {
-        cout << "ERROR READING THE SHADER FILES" << endl;
-    }
-
-
-    //convierte las srings que almacenaban el codigo en un array de char (esto pq es como lo lee openGL
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+    uint64_t cacheKey = ProgramCache::key(vertexCode, fragmentCode);
+    unsigned int program = ProgramCache::load(cacheKey);
+    linked = program != 0;
+    if (linked)
+       return program;
+
+    //OpenGL recibe el codigo con su longitud, no hace falta que acabe en 0
+    const char* vShaderCode = vertexCode.data();
+    const char* fShaderCode = fragmentCode.data();
+    int vShaderLength = int(vertexCode.size());
+    int fShaderLength = int(fragmentCode.size());
 
     //Guarda las "id" de los shaders
     unsigned int vertex, fragment;
@@ -59,7 +39,7 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 
     //Compila el vertex shader
     vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
+    glShaderSource(vertex, 1, &vShaderCode, &vShaderLength);
     glCompileShader(vertex);
 
     //Comprueba si ha habido algun error
@@ -72,7 +52,7 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
 
     //Compila el vertex shader
     fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
+    glShaderSource(fragment, 1, &fShaderCode, &fShaderLength);
     glCompileShader(fragment);
 
     //Comprueba si ha habido algun error
@@ -84,15 +64,147 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath)
     };
 
     //Crea el program shader
-    ID = glCreateProgram();
-    glAttachShader(ID, vertex);
-    glAttachShader(ID, fragment);
-    glLinkProgram(ID);
+    program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    ProgramCache::prepareForStore(program);
+    glLinkProgram(program);
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    //Solo se guardan los programas que han enlazado bien
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(!success)
+    {
+       glGetProgramInfoLog(program, 512, NULL, infoLog); 
+       std::cout << "FALLO AL ENLAZAR EL SHADER\n" << infoLog << std::endl;
+    }else
+       ProgramCache::store(cacheKey, program);
+
+    linked = success;
+    return program;
+}
+
+//Crea el shader, se debe pasar el nombre del asset del vertex shader y del fragment ("shader/shader.vs")
+HashMap<std::string, Shader*> Shader::permutations;
+
+Shader::Shader(const char* vertexName, const char* fragmentName, std::string_view defines): generation(0), vertexName(vertexName), fragmentName(fragmentName), defines(normalizeShaderDefines(defines))
+{
+    StartupPhase phase("shaders");
+    ID = build(false);
 };
 
+//Preprocesa los dos shaders y los compila, 0 si falta algun archivo o no enlaza
+unsigned int Shader::build(bool fromFile)
+{
+    //El codigo se lee directamente del pack (o del archivo proyectado), sin copiar mas que lo que se incluye
+    ShaderSource vertexSource;
+    ShaderSource fragmentSource;
+    if (!preprocessShader(vertexName, defines, fromFile, vertexSource) || !preprocessShader(fragmentName, defines, fromFile, fragmentSource))
+    {
+        cout << "ERROR READING THE SHADER FILES" << endl;
+        return 0;
+    }
+
+    bool linked;
+    unsigned int program = buildProgram(vertexSource.code, fragmentSource.code, linked);
+    if (!linked)
+    {
+        //Los errores del driver dan el numero de fuente de los #line
+        cout << vertexName << " + " << fragmentName << " [" << defines << "]" << endl;
+        for (size_t i = 0; i < vertexSource.files.size(); i++)
+           cout << "  vertex " << i << ": " << vertexSource.files[i] << endl;
+        for (size_t i = 0; i < fragmentSource.files.size(); i++)
+           cout << "  fragment " << i << ": " << fragmentSource.files[i] << endl;
+
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    assets = vertexSource.files;
+    assets.insert(assets.end(), fragmentSource.files.begin(), fragmentSource.files.end());
+    return program;
+}
+
+//Recompila desde los archivos sueltos, si falla se queda el programa anterior
+bool Shader::reload()
+{
+    unsigned int program = build(true);
+    if (program == 0)
+    {
+        cout << "Se mantiene la version anterior de " << vertexName << " + " << fragmentName << endl;
+        return false;
+    }
+
+    glDeleteProgram(ID);
+    ID = program;
+
+    //Los enlaces de los uniform blocks son del programa, hay que repetirlos
+    for (const std::pair<std::string, unsigned int>& block : uniformBlocks)
+    {
+        unsigned int index = glGetUniformBlockIndex(ID, block.first.c_str());
+        if (index != GL_INVALID_INDEX)
+           glUniformBlockBinding(ID, index, block.second);
+    }
+
+    generation++;
+    return true;
+}
+
+Shader& Shader::get(const char* vertexName, const char* fragmentName, std::string_view defines)
+{
+    std::string key = vertexName;
+    key += '\0';
+    key += fragmentName;
+    key += '\0';
+    key += normalizeShaderDefines(defines);
+
+    HashMap<std::string, Shader*>::iterator found = permutations.find(key);
+    if (found != permutations.end())
+       return *found->second;
+
+    Shader* shader = new Shader(vertexName, fragmentName, defines);
+    permutations.insert(key, shader);
+    return *shader;
+}
+
+bool Shader::reloadUsing(std::string_view name)
+{
+    bool used = false;
+    for (const std::pair<std::string, Shader*>& permutation : permutations)
+    {
+        if (permutation.second->usesAsset(name))
+        {
+            permutation.second->reload();
+            used = true;
+        }
+    }
+    return used;
+}
+
+void Shader::clearPermutations()
+{
+    for (const std::pair<std::string, Shader*>& permutation : permutations)
+    {
+        glDeleteProgram(permutation.second->ID);
+        delete permutation.second;
+    }
+    permutations.clear();
+}
+
+size_t Shader::permutationCount()
+{
+    return permutations.size();
+}
+
+//Si el shader usa ese asset
+bool Shader::usesAsset(std::string_view name) const
+{
+    //Si la ultima compilacion fallo no se sabe que incluye, al menos los dos shaders
+    return name == vertexName || name == fragmentName || std::find(assets.begin(), assets.end(), name) != assets.end();
+}
+
 //Utilizarlo
 void Shader::use(){
    glUseProgram(ID);
@@ -115,3 +227,22 @@ void Shader::setFloat(const std::string &name, float value) const
 {
    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
 }
+
+//Enlaza un uniform block (GL 3.3 no permite layout(binding) en el shader)
+void Shader::bindUniformBlock(const char* blockName, unsigned int binding)
+{
+   unsigned int index = glGetUniformBlockIndex(ID, blockName);
+   if (index != GL_INVALID_INDEX)
+      glUniformBlockBinding(ID, index, binding);
+
+   //Una permutacion compartida recibe el mismo enlace de todos los que la usan
+   for (std::pair<std::string, unsigned int>& block : uniformBlocks)
+   {
+      if (block.first == blockName)
+      {
+         block.second = binding;
+         return;
+      }
+   }
+   uniformBlocks.push_back(std::make_pair(std::string(blockName), binding));
+}
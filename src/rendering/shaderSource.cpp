@@ -0,0 +1,238 @@
+#include "include/rendering/shaderSource.h"
+#include "include/assetPack.h"
+
+#include <algorithm>
+#include <cstdio>
+
+//Los #include anidados mas alla de esto son casi seguro un error
+const int MAX_INCLUDE_DEPTH = 16;
+
+static std::string_view trimStart(std::string_view text){
+   size_t start = text.find_first_not_of(" \t");
+   return start == std::string_view::npos ? std::string_view() : text.substr(start);
+}
+
+//Si la linea es una directiva (#nombre, con espacios permitidos despues de '#') devuelve el resto
+static bool directive(std::string_view line, std::string_view name, std::string_view& rest){
+   line = trimStart(line);
+   if (line.empty() || line[0] != '#')
+      return false;
+
+   line = trimStart(line.substr(1));
+   if (line.substr(0, name.size()) != name)
+      return false;
+
+   rest = trimStart(line.substr(name.size()));
+   return true;
+}
+
+static std::string_view defineName(std::string_view define){
+   return define.substr(0, define.find('='));
+}
+
+std::string normalizeShaderDefines(std::string_view defines){
+   std::vector<std::string_view> tokens;
+   while (!(defines = trimStart(defines)).empty()){
+      size_t end = defines.find_first_of(" \t");
+      tokens.push_back(defines.substr(0, end));
+      defines = end == std::string_view::npos ? std::string_view() : defines.substr(end);
+   }
+
+   //Ordenadas por nombre sin cambiar el orden de las que se llaman igual, de esas se queda la ultima
+   std::stable_sort(tokens.begin(), tokens.end(), [](std::string_view a, std::string_view b){ return defineName(a) < defineName(b); });
+
+   std::string normalized;
+   for (size_t i = 0; i < tokens.size(); i++){
+      if (i + 1 < tokens.size() && defineName(tokens[i + 1]) == defineName(tokens[i]))
+         continue;
+
+      if (!normalized.empty())
+         normalized += ' ';
+      normalized += tokens[i];
+   }
+   return normalized;
+}
+
+static void appendDefines(std::string& code, std::string_view defines){
+   std::string normalized = normalizeShaderDefines(defines);
+   std::string_view rest = normalized;
+
+   while (!rest.empty()){
+      size_t end = rest.find(' ');
+      std::string_view define = rest.substr(0, end);
+      rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+      size_t equals = define.find('=');
+      code += "#define ";
+      code += define.substr(0, equals);
+      code += ' ';
+      if (equals == std::string_view::npos)
+         code += '1';
+      else
+         code += define.substr(equals + 1);
+      code += '\n';
+   }
+}
+
+//Sigue los comentarios /* */ de una linea: inComment dice si la linea empieza dentro de uno y al acabar si sigue abierto
+//Un // fuera de un comentario de bloque se come el resto de la linea
+static void skipComments(std::string_view line, bool& inComment){
+   for (size_t i = 0; i + 1 < line.size(); i++){
+      if (inComment){
+         if (line[i] == '*' && line[i + 1] == '/'){
+            inComment = false;
+            i++;
+         }
+      }else if (line[i] == '/' && line[i + 1] == '/'){
+         return;
+      }else if (line[i] == '/' && line[i + 1] == '*'){
+         inComment = true;
+         i++;
+      }
+   }
+}
+
+static bool hasVersion(std::string_view text){
+   std::string_view rest;
+   bool inComment = false;
+   while (!text.empty()){
+      size_t end = text.find('\n');
+      std::string_view line = text.substr(0, end);
+      if (!inComment && directive(line, "version", rest))
+         return true;
+      skipComments(line, inComment);
+      text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+   }
+   return false;
+}
+
+//Carpeta del que incluye mas la ruta del #include, quitando "." y "..": el pack busca por nombre exacto
+//y asi un archivo incluido por dos caminos distintos se reconoce como el mismo
+static std::string includePath(const std::string& folder, std::string_view relative){
+   std::vector<std::string_view> parts;
+   std::string joined = folder + std::string(relative);
+   std::string_view rest = joined;
+   while (!rest.empty()){
+      size_t end = rest.find('/');
+      std::string_view part = rest.substr(0, end);
+      rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+
+      if (part == ".." && !parts.empty() && parts.back() != "..")
+         parts.pop_back();
+      else if (!part.empty() && part != ".")
+         parts.push_back(part);
+   }
+
+   std::string path;
+   for (std::string_view part : parts){
+      if (!path.empty())
+         path += '/';
+      path += part;
+   }
+   return path;
+}
+
+static void appendLine(std::string& code, size_t line, size_t file){
+   code += "#line " + std::to_string(line) + " " + std::to_string(file) + "\n";
+}
+
+static bool appendFile(const std::string& name, std::string_view defines, const ShaderReader& read, int depth, ShaderSource& source){
+   std::string contents;
+   if (!read(name, contents)){
+      printf("No se encuentra el shader %s\n", name.c_str());
+      return false;
+   }
+
+   size_t fileIndex = source.files.size();
+   source.files.push_back(name);
+   std::string folder = name.substr(0, name.rfind('/') + 1);
+
+   //Sin #version las defines van al principio
+   bool definesAdded = depth > 0;
+   if (!definesAdded && !hasVersion(contents)){
+      appendDefines(source.code, defines);
+      appendLine(source.code, 1, fileIndex);
+      definesAdded = true;
+   }
+
+   std::string_view text = contents;
+   size_t lineNumber = 0;
+   bool inComment = false;
+   while (!text.empty()){
+      size_t end = text.find('\n');
+      std::string_view line = text.substr(0, end);
+      text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+      lineNumber++;
+
+      if (!line.empty() && line.back() == '\r')
+         line.remove_suffix(1);
+
+      //Las directivas dentro de un comentario de bloque son texto
+      bool commented = inComment;
+      skipComments(line, inComment);
+
+      std::string_view rest;
+      if (commented){
+         source.code += line;
+         source.code += '\n';
+      }else if (directive(line, "version", rest)){
+         if (depth > 0){
+            printf("%s: #version solo puede estar en el shader, no en un include\n", name.c_str());
+            return false;
+         }
+
+         source.code += line;
+         source.code += '\n';
+         if (!definesAdded){
+            appendDefines(source.code, defines);
+            definesAdded = true;
+         }
+         appendLine(source.code, lineNumber + 1, fileIndex);
+      }else if (directive(line, "include", rest)){
+         size_t close = rest.size() > 1 && rest[0] == '"' ? rest.find('"', 1) : std::string_view::npos;
+         if (close == std::string_view::npos){
+            printf("%s(%zu): #include tiene que ser #include \"archivo\"\n", name.c_str(), lineNumber);
+            return false;
+         }
+
+         std::string included = includePath(folder, rest.substr(1, close - 1));
+         //Ya incluido: una linea vacia para que las siguientes sigan en su numero
+         if (std::find(source.files.begin(), source.files.end(), included) != source.files.end()){
+            source.code += '\n';
+            continue;
+         }
+
+         if (depth + 1 >= MAX_INCLUDE_DEPTH){
+            printf("%s(%zu): demasiados #include anidados\n", name.c_str(), lineNumber);
+            return false;
+         }
+
+         appendLine(source.code, 1, source.files.size());
+         if (!appendFile(included, defines, read, depth + 1, source))
+            return false;
+         appendLine(source.code, lineNumber + 1, fileIndex);
+      }else{
+         source.code += line;
+         source.code += '\n';
+      }
+   }
+
+   return true;
+}
+
+bool preprocessShaderWith(const std::string& name, std::string_view defines, const ShaderReader& read, ShaderSource& source){
+   source.code.clear();
+   source.files.clear();
+   return appendFile(name, defines, read, 0, source);
+}
+
+bool preprocessShader(const std::string& name, std::string_view defines, bool fromFile, ShaderSource& source){
+   return preprocessShaderWith(name, defines, [fromFile](const std::string& file, std::string& contents){
+      Asset asset;
+      if (!(fromFile ? asset.loadFile(file) : asset.load(file)))
+         return false;
+
+      contents.assign(asset.text());
+      return true;
+   }, source);
+}
@@ -0,0 +1,153 @@
+#include "include/rendering/spriteRenderer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <glad/glad.h>
+
+SpriteRenderer::SpriteRenderer(): drawCalls(0), drawnSprites(0), culledSprites(0), shader(Shader::get("shader/shader.vs", "shader/shader.fs", "INSTANCED")), instanceCapacity(0){
+   float vertices[] = {
+      0.5,  0.5, 1.0f, 1.0f,        // top right
+      0.5, -0.5, 1.0f, 0.0f,        // bottom right
+      -0.5, -0.5, 0.0f, 0.0f,       // bottom left
+      -0.5,  0.5, 0.0f, 1.0f        // top left
+   };
+
+   unsigned int indices[] = {
+      0, 1, 3,
+      1, 2, 3
+   };
+
+   //Crea el VAO VBO y EBO del quad, compartido por todos los sprites
+   glGenVertexArrays(1, &VAO);
+   glGenBuffers(1, &VBO);
+   glGenBuffers(1, &EBO);
+   glGenBuffers(1, &instanceVBO);
+
+   glBindVertexArray(VAO);
+
+   glBindBuffer(GL_ARRAY_BUFFER, VBO);
+   glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16, vertices, GL_STATIC_DRAW);
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+   glEnableVertexAttribArray(0);
+
+   glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+   glEnableVertexAttribArray(1);
+
+   //Atributos por instancia: las tres columnas del Affine2D
+   glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+   glEnableVertexAttribArray(2);
+   glEnableVertexAttribArray(3);
+   glEnableVertexAttribArray(4);
+   glVertexAttribDivisor(2, 1);
+   glVertexAttribDivisor(3, 1);
+   glVertexAttribDivisor(4, 1);
+   setInstanceOffset(0);
+
+   glBindVertexArray(0);
+
+   shader.bindUniformBlock("Projection", PROJECTION_BINDING);
+}
+
+SpriteRenderer::~SpriteRenderer(){
+   glDeleteBuffers(1, &VBO);
+   glDeleteBuffers(1, &EBO);
+   glDeleteBuffers(1, &instanceVBO);
+   glDeleteVertexArrays(1, &VAO);
+}
+
+//GL 3.3 no tiene glDrawElementsInstancedBaseInstance, cada grupo mueve el inicio de los atributos por instancia
+void SpriteRenderer::setInstanceOffset(uint32_t offset){
+   size_t base = size_t(offset) * sizeof(SpriteInstance);
+
+   glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+   glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(Affine2D, a)));
+   glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(Affine2D, c)));
+   glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(Affine2D, tx)));
+}
+
+void SpriteRenderer::render(const SpriteStore& sprites, glm::vec2 viewMin, glm::vec2 viewMax){
+   drawCalls = 0;
+   drawnSprites = 0;
+   culledSprites = 0;
+
+   size_t count = sprites.size();
+   if (count == 0)
+      return;
+
+   const Affine2D* models = sprites.modelData();
+   const uint8_t* layers = sprites.layerData();
+   const unsigned int* textures = sprites.textureData();
+
+   //Primera pasada: cuantos sprites visibles hay de cada capa y textura, los que no se ven no van a ningun grupo
+   batchIndex.clear();
+   batches.clear();
+   spriteBatch.resize(count);
+
+   for (size_t i = 0; i < count; i++){
+      if (!quadInRect(models[i], viewMin, viewMax)){
+         spriteBatch[i] = culled;
+         culledSprites++;
+         continue;
+      }
+
+      uint64_t key = (uint64_t(layers[i]) << 32) | textures[i];
+
+      std::pair<HashMap<uint64_t, uint32_t>::iterator, bool> inserted = batchIndex.insert(key, uint32_t(batches.size()));
+      if (inserted.second)
+         batches.push_back(Batch{ key, textures[i], 0, 0, uint32_t(batches.size()) });
+
+      uint32_t batch = inserted.first->second;
+      batches[batch].count++;
+      spriteBatch[i] = batch;
+   }
+
+   //Los grupos se ordenan por capa, son pocos
+   std::sort(batches.begin(), batches.end(), [](const Batch& a, const Batch& b){ return a.key < b.key; });
+
+   remap.resize(batches.size());
+   uint32_t offset = 0;
+   for (size_t i = 0; i < batches.size(); i++){
+      remap[batches[i].previousIndex] = uint32_t(i);
+      batches[i].offset = offset;
+      offset += batches[i].count;
+   }
+
+   drawnSprites = uint32_t(count) - culledSprites;
+   if (drawnSprites == 0)
+      return;
+
+   //Segunda pasada: cada sprite se escribe en el hueco de su grupo
+   instances.resize(drawnSprites);
+   for (size_t i = 0; i < count; i++){
+      if (spriteBatch[i] == culled)
+         continue;
+
+      Batch& batch = batches[remap[spriteBatch[i]]];
+      instances[batch.offset++] = SpriteInstance{ models[i] };
+   }
+
+   //Sube las instancias, el buffer solo crece
+   glBindVertexArray(VAO);
+   glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+   if (instances.size() > instanceCapacity){
+      instanceCapacity = std::max(instances.size(), instanceCapacity * 2);
+      glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(SpriteInstance), nullptr, GL_DYNAMIC_DRAW);
+   }
+   glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(SpriteInstance), instances.data());
+
+   shader.use();
+
+   //offset se ha movido al final de cada grupo durante la segunda pasada
+   for (const Batch& batch : batches){
+      glBindTexture(GL_TEXTURE_2D, batch.texture);
+      setInstanceOffset(batch.offset - batch.count);
+      glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, batch.count);
+      drawCalls++;
+   }
+
+   glBindVertexArray(0);
+}
@@ -0,0 +1,257 @@
+#include "include/rendering/spriteStore.h"
+#include "include/rendering/transformKernel.h"
+
+#include <cmath>
+#include <cstring>
+
+SpriteHandle SpriteStore::add(unsigned int texture, float x, float y, float width, float heigth, uint8_t layer){
+   uint32_t index;
+   if (freeHead != noSlot){
+      index = freeHead;
+      freeHead = slots[index].denseIndex;
+   }else{
+      index = uint32_t(slots.size());
+      slots.push_back(Slot{ 0, 1 });
+   }
+
+   slots[index].denseIndex = uint32_t(textures.size());
+
+   positions.push_back(glm::vec2(x, y));
+   scales.push_back(glm::vec2(width, heigth));
+   rotations.push_back(0);
+   layers.push_back(layer);
+   textures.push_back(texture);
+   models.push_back(Affine2D::identity());
+   dirty.push_back(0);
+   itemSlots.push_back(index);
+
+   markDirty(slots[index].denseIndex);
+   updateBounds(slots[index].denseIndex);
+
+   return SpriteHandle{ index, slots[index].generation };
+}
+
+bool SpriteStore::remove(SpriteHandle sprite){
+   uint32_t dense = denseIndex(sprite);
+   if (dense == noSlot)
+      return false;
+
+   //El ultimo sprite ocupa el hueco en todos los arrays
+   uint32_t last = uint32_t(textures.size() - 1);
+   if (dirty[dense])
+      dirtyCount--;
+
+   if (dense != last){
+      positions[dense] = positions[last];
+      scales[dense] = scales[last];
+      rotations[dense] = rotations[last];
+      layers[dense] = layers[last];
+      textures[dense] = textures[last];
+      models[dense] = models[last];
+      dirty[dense] = dirty[last];
+      itemSlots[dense] = itemSlots[last];
+      slots[itemSlots[dense]].denseIndex = dense;
+   }
+
+   spatialIndex.remove(sprite.index);
+
+   positions.pop_back();
+   scales.pop_back();
+   rotations.pop_back();
+   layers.pop_back();
+   textures.pop_back();
+   models.pop_back();
+   dirty.pop_back();
+   itemSlots.pop_back();
+
+   Slot& slot = slots[sprite.index];
+   slot.generation++;
+   slot.denseIndex = freeHead;
+   freeHead = sprite.index;
+
+   return true;
+}
+
+bool SpriteStore::contains(SpriteHandle sprite) const{
+   return denseIndex(sprite) != noSlot;
+}
+
+uint32_t SpriteStore::denseIndex(SpriteHandle sprite) const{
+   if (sprite.index >= slots.size() || sprite.generation == 0 || slots[sprite.index].generation != sprite.generation)
+      return noSlot;
+
+   return slots[sprite.index].denseIndex;
+}
+
+void SpriteStore::setPosition(SpriteHandle sprite, float x, float y){
+   uint32_t dense = denseIndex(sprite);
+   if (dense != noSlot){
+      positions[dense] = glm::vec2(x, y);
+      markDirty(dense);
+      updateBounds(dense);
+   }
+}
+
+void SpriteStore::setScale(SpriteHandle sprite, float width, float heigth){
+   uint32_t dense = denseIndex(sprite);
+   if (dense != noSlot){
+      scales[dense] = glm::vec2(width, heigth);
+      markDirty(dense);
+      updateBounds(dense);
+   }
+}
+
+void SpriteStore::setRotation(SpriteHandle sprite, float rotation){
+   uint32_t dense = denseIndex(sprite);
+   if (dense != noSlot){
+      rotations[dense] = rotation;
+      markDirty(dense);
+      updateBounds(dense);
+   }
+}
+
+void SpriteStore::setTexture(SpriteHandle sprite, unsigned int texture){
+   uint32_t dense = denseIndex(sprite);
+   if (dense != noSlot)
+      textures[dense] = texture;
+}
+
+void SpriteStore::setLayer(SpriteHandle sprite, uint8_t layer){
+   uint32_t dense = denseIndex(sprite);
+   if (dense != noSlot)
+      layers[dense] = layer;
+}
+
+glm::vec2 SpriteStore::getPosition(SpriteHandle sprite) const{
+   uint32_t dense = denseIndex(sprite);
+   return dense != noSlot ? positions[dense] : glm::vec2(0);
+}
+
+glm::vec2 SpriteStore::getScale(SpriteHandle sprite) const{
+   uint32_t dense = denseIndex(sprite);
+   return dense != noSlot ? scales[dense] : glm::vec2(0);
+}
+
+float SpriteStore::getRotation(SpriteHandle sprite) const{
+   uint32_t dense = denseIndex(sprite);
+   return dense != noSlot ? rotations[dense] : 0;
+}
+
+unsigned int SpriteStore::getTexture(SpriteHandle sprite) const{
+   uint32_t dense = denseIndex(sprite);
+   return dense != noSlot ? textures[dense] : 0;
+}
+
+void SpriteStore::markDirty(uint32_t dense){
+   if (!dirty[dense]){
+      dirty[dense] = 1;
+      dirtyCount++;
+   }
+}
+
+//La caja del quad girado, sin esperar a updateModels
+void SpriteStore::updateBounds(uint32_t dense){
+   float radians = rotations[dense] * 3.14159265358979323846f / 180.0f;
+   float sine = std::fabs(std::sin(radians));
+   float cosine = std::fabs(std::cos(radians));
+   glm::vec2 scale(std::fabs(scales[dense].x), std::fabs(scales[dense].y));
+
+   glm::vec2 half = glm::vec2(cosine * scale.x + sine * scale.y, sine * scale.x + cosine * scale.y) * 0.5f;
+   spatialIndex.update(itemSlots[dense], positions[dense] - half, positions[dense] + half);
+}
+
+size_t SpriteStore::pick(glm::vec2 point, SpriteHandle* results, size_t capacity) const{
+   size_t found = 0;
+
+   spatialIndex.forEachAtPoint(point, [&](uint32_t slot){
+      uint32_t dense = slots[slot].denseIndex;
+
+      //La caja es mas grande que el sprite si esta girado, se comprueba en los ejes del sprite
+      float radians = rotations[dense] * 3.14159265358979323846f / 180.0f;
+      float sine = std::sin(radians);
+      float cosine = std::cos(radians);
+      glm::vec2 offset = point - positions[dense];
+      glm::vec2 local(cosine * offset.x + sine * offset.y, -sine * offset.x + cosine * offset.y);
+      if (std::fabs(local.x) > std::fabs(scales[dense].x) * 0.5f || std::fabs(local.y) > std::fabs(scales[dense].y) * 0.5f)
+         return;
+
+      //Se insertan ordenados por capa, si no caben se quedan los de las capas mas altas
+      size_t position = found < capacity ? found : capacity;
+      found++;
+      while (position > 0 && layers[denseIndex(results[position - 1])] < layers[dense]){
+         if (position < capacity)
+            results[position] = results[position - 1];
+         position--;
+      }
+      if (position < capacity)
+         results[position] = SpriteHandle{ slot, slots[slot].generation };
+   });
+
+   return found;
+}
+
+size_t SpriteStore::queryRect(glm::vec2 min, glm::vec2 max, SpriteHandle* results, size_t capacity) const{
+   size_t found = 0;
+
+   spatialIndex.forEachInRect(min, max, [&](uint32_t slot){
+      if (found < capacity)
+         results[found] = SpriteHandle{ slot, slots[slot].generation };
+      found++;
+   });
+
+   return found;
+}
+
+size_t SpriteStore::nearest(glm::vec2 point, size_t k, SpriteHandle* results) const{
+   if (nearestSlots.size() < k){
+      nearestSlots.resize(k);
+      nearestDistances.resize(k);
+   }
+
+   size_t found = spatialIndex.nearest(point, k, nearestSlots.data(), nearestDistances.data());
+   for (size_t i = 0; i < found; i++)
+      results[i] = SpriteHandle{ nearestSlots[i], slots[nearestSlots[i]].generation };
+
+   return found;
+}
+
+//Si ha cambiado mas o menos una cuarta parte se recalcula todo con SIMD, si no solo los que han cambiado
+void SpriteStore::updateModels(){
+   if (dirtyCount == 0)
+      return;
+
+   size_t count = textures.size();
+   if (dirtyCount * 4 >= count){
+      buildTransforms(positions.data(), scales.data(), rotations.data(), models.data(), count);
+      memset(dirty.data(), 0, count);
+   }else{
+      for (size_t i = 0; i < count; i++){
+         if (!dirty[i])
+            continue;
+
+         buildTransforms(&positions[i], &scales[i], &rotations[i], &models[i], 1, kernelScalar);
+         dirty[i] = 0;
+      }
+   }
+
+   dirtyCount = 0;
+}
+
+void SpriteStore::reserve(size_t capacity){
+   positions.reserve(capacity);
+   scales.reserve(capacity);
+   rotations.reserve(capacity);
+   layers.reserve(capacity);
+   textures.reserve(capacity);
+   models.reserve(capacity);
+   dirty.reserve(capacity);
+   itemSlots.reserve(capacity);
+   slots.reserve(capacity);
+}
+
+void SpriteStore::clear(){
+   while (!itemSlots.empty())
+      remove(SpriteHandle{ itemSlots.back(), slots[itemSlots.back()].generation });
+
+   spatialIndex.clear();
+}
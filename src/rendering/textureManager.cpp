@@ -0,0 +1,321 @@
+#include "include/rendering/textureManager.h"
+#include "include/rendering/bakedTexture.h"
+#include "include/rendering/stb_image.h"
+#include "include/assetPack.h"
+#include "include/startupTrace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <glad/glad.h>
+
+//Los pixeles del nivel 0 de una imagen, del .tex horneado o decodificados con stb_image
+struct Image{
+   Asset asset;
+   BakedTexture baked;
+   bool isBaked = false;
+   unsigned char* decoded = nullptr;
+   const uint8_t* pixels = nullptr;
+   uint32_t width = 0, height = 0;
+
+   Image() = default;
+   Image(const Image&) = delete;
+   Image& operator=(const Image&) = delete;
+   ~Image(){ stbi_image_free(decoded); }
+};
+
+//Sin fromFile: del pack, o si no del .tex de assetbaker que haya al lado de la imagen, o de la imagen
+//El .tex solo si es mas nuevo que la imagen, si no es que se ha editado la imagen sin volver a hornear
+//Con fromFile solo de la imagen suelta, es lo que se acaba de editar
+static bool readImage(const std::string& name, bool fromFile, Image& image){
+   bool found = fromFile ? image.asset.loadFile(name) : image.asset.load(name);
+   image.isBaked = found && image.baked.parse(image.asset.data(), image.asset.size());
+   if (!image.isBaked && !fromFile && !image.asset.fromPack()){
+      std::string imagePath = Asset::loosePath(name);
+      std::string bakedPath = bakedTexturePath(imagePath);
+      std::error_code error;
+      if (bakedTextureIsCurrent(imagePath, bakedPath))
+         image.isBaked = image.baked.load(bakedPath);
+      else if (found && std::filesystem::exists(bakedPath, error))
+         printf("%s es mas viejo que %s, se usa la imagen\n", bakedPath.c_str(), name.c_str());
+   }
+
+   if (image.isBaked){
+      image.pixels = image.baked.levelData(0);
+      image.width = image.baked.width();
+      image.height = image.baked.height();
+      return true;
+   }
+
+   if (!found)
+      return false;
+
+   //Siempre a RGBA, asi las filas nunca necesitan alineacion
+   int width, height, channels;
+   stbi_set_flip_vertically_on_load(true);
+   image.decoded = stbi_load_from_memory(image.asset.data(), int(image.asset.size()), &width, &height, &channels, 4);
+   if (image.decoded == nullptr)
+      return false;
+
+   image.pixels = image.decoded;
+   image.width = uint32_t(width);
+   image.height = uint32_t(height);
+   return true;
+}
+
+//Hash de los pixeles y las opciones, de 8 en 8 bytes
+static uint64_t contentHash(const Image& image, TextureOptions options){
+   const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+   uint64_t hash = (uint64_t(image.width) << 32 | image.height) * multiplier;
+   hash ^= uint64_t(options.format) | uint64_t(options.filter) << 8 | uint64_t(options.mipmaps) << 16;
+
+   size_t size = size_t(image.width) * image.height * 4;
+   size_t i = 0;
+   for (; i + 8 <= size; i += 8){
+      uint64_t word;
+      memcpy(&word, image.pixels + i, 8);
+      hash = (hash ^ word) * multiplier;
+      hash ^= hash >> 29;
+   }
+   for (; i < size; i++)
+      hash = (hash ^ image.pixels[i]) * multiplier;
+
+   return hash;
+}
+
+//El hash puede coincidir sin que las imagenes sean iguales: se vuelve a leer la de la textura y se comparan los pixeles
+static bool sameContent(const std::string& name, bool fromFile, const Image& image){
+   Image other;
+   if (!readImage(name, fromFile, other))
+      return false;
+
+   return other.width == image.width && other.height == image.height &&
+          memcmp(other.pixels, image.pixels, size_t(image.width) * image.height * 4) == 0;
+}
+
+//Sube la imagen a la textura que este enlazada segun las opciones, devuelve los bytes que ocupa
+static size_t upload(const Image& image, TextureOptions options){
+   GLenum internalFormat = options.format == textureRGB ? GL_RGB : GL_RGBA;
+   size_t bytes = size_t(image.width) * image.height * 4;
+
+   if (options.mipmaps && image.isBaked && image.baked.mipCount() > 1){
+      //Las filas RGBA no tienen relleno, con 4 bytes por pixel la alineacion por defecto (4) siempre vale
+      for (uint32_t level = 0; level < image.baked.mipCount(); level++)
+         glTexImage2D(GL_TEXTURE_2D, level, internalFormat, image.baked.levelWidth(level), image.baked.levelHeight(level), 0, GL_RGBA, GL_UNSIGNED_BYTE, image.baked.levelData(level));
+
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.baked.mipCount() - 1);
+   }else{
+      glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.pixels);
+
+      if (options.mipmaps){
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+         glGenerateMipmap(GL_TEXTURE_2D);
+      }else{
+         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+      }
+   }
+
+   //Los mipmaps ocupan un tercio mas
+   if (options.mipmaps){
+      for (uint32_t width = image.width, height = image.height; width > 1 || height > 1;){
+         width = width > 1 ? width / 2 : 1;
+         height = height > 1 ? height / 2 : 1;
+         bytes += size_t(width) * height * 4;
+      }
+   }
+
+   GLint magFilter = options.filter == filterLinear ? GL_LINEAR : GL_NEAREST;
+   GLint minFilter = magFilter;
+   if (options.mipmaps)
+      minFilter = options.filter == filterLinear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+
+   return bytes;
+}
+
+//El nombre y las opciones juntos, el '\0' no puede estar en un nombre
+std::string TextureManager::nameKey(const std::string& name, TextureOptions options){
+   std::string key = name;
+   key += '\0';
+   key += char('0' + options.format);
+   key += char('0' + options.filter);
+   key += char('0' + options.mipmaps);
+   return key;
+}
+
+TextureHandle TextureManager::load(const std::string& name, TextureOptions options){
+   std::string key = nameKey(name, options);
+
+   HashMap<std::string, TextureHandle>::iterator known = byName.find(key);
+   if (known != byName.end()){
+      acquire(known->second);
+      return known->second;
+   }
+
+   StartupPhase phase("textures");
+   Image image;
+   if (!readImage(name, false, image)){
+      printf("No se puede cargar la textura %s\n", name.c_str());
+      return TextureHandle();
+   }
+
+   //Otro nombre con la misma imagen: se comparte la textura
+   uint64_t contentKey = contentHash(image, options);
+   HashMap<uint64_t, TextureHandle>::iterator same = shareContent ? byContent.find(contentKey) : byContent.end();
+   if (same != byContent.end()){
+      TextureHandle handle = same->second;
+      const Texture* texture = textures.get(handle);
+      if (sameContent(texture->name, texture->fromFile, image)){
+         acquire(handle);
+         byName.insert(key, handle);
+         return handle;
+      }
+   }
+
+   unsigned int texture = 0;
+   glGenTextures(1, &texture);
+   glBindTexture(GL_TEXTURE_2D, texture);
+   size_t bytes = upload(image, options);
+
+   TextureHandle handle = textures.insert(Texture{ name, options, texture, 1, contentKey, image.width, image.height, bytes, false });
+   byName.insert(key, handle);
+   byTexture.insert(texture, handle);
+   if (same == byContent.end())
+      byContent.insert(contentKey, handle);
+   totalBytes += bytes;
+
+   return handle;
+}
+
+void TextureManager::acquire(TextureHandle handle){
+   Texture* texture = textures.get(handle);
+   if (texture != nullptr)
+      texture->references++;
+}
+
+void TextureManager::release(TextureHandle handle){
+   Texture* texture = textures.get(handle);
+   if (texture == nullptr)
+      return;
+
+   if (--texture->references == 0)
+      remove(handle);
+}
+
+TextureHandle TextureManager::find(unsigned int glTexture) const{
+   HashMap<unsigned int, TextureHandle>::const_iterator found = byTexture.find(glTexture);
+   return found != byTexture.end() ? found->second : TextureHandle();
+}
+
+unsigned int TextureManager::glTexture(TextureHandle handle) const{
+   const Texture* texture = textures.get(handle);
+   return texture ? texture->texture : 0;
+}
+
+uint32_t TextureManager::references(TextureHandle handle) const{
+   const Texture* texture = textures.get(handle);
+   return texture ? texture->references : 0;
+}
+
+//Borra la textura y todos los nombres que apuntan a ella
+void TextureManager::remove(TextureHandle handle){
+   Texture* texture = textures.get(handle);
+   if (texture == nullptr)
+      return;
+
+   glDeleteTextures(1, &texture->texture);
+   byTexture.erase(texture->texture);
+   totalBytes -= texture->bytes;
+   HashMap<uint64_t, TextureHandle>::iterator content = byContent.find(texture->contentKey);
+   if (content != byContent.end() && content->second == handle)
+      byContent.erase(content);
+
+   for (HashMap<std::string, TextureHandle>::iterator it = byName.begin(); it != byName.end();){
+      if (it->second == handle)
+         it = byName.erase(it);
+      else
+         ++it;
+   }
+
+   textures.remove(handle);
+}
+
+//Todas las texturas pedidas con ese nombre, con cualquier opcion
+//Una textura que comparte otro nombre por tener el mismo contenido no se toca: los dos usan el mismo id de OpenGL
+//y el otro tambien cambiaria. Con la recarga activa no se comparten (ver setShareContent)
+bool TextureManager::reload(std::string_view name){
+   std::vector<TextureHandle> handles;
+   for (const std::pair<std::string, TextureHandle>& entry : byName){
+      std::string_view entryName(entry.first.data(), entry.first.find('\0'));
+      if (entryName == name && std::find(handles.begin(), handles.end(), entry.second) == handles.end())
+         handles.push_back(entry.second);
+   }
+
+   for (const std::pair<std::string, TextureHandle>& entry : byName){
+      std::string_view entryName(entry.first.data(), entry.first.find('\0'));
+      std::vector<TextureHandle>::iterator shared = std::find(handles.begin(), handles.end(), entry.second);
+      if (entryName != name && shared != handles.end()){
+         printf("%.*s comparte la textura con %.*s, no se recarga\n", int(name.size()), name.data(), int(entryName.size()), entryName.data());
+         handles.erase(shared);
+      }
+   }
+
+   if (handles.empty())
+      return false;
+
+   Image image;
+   if (!readImage(std::string(name), true, image)){
+      printf("No se puede leer %.*s, se mantiene la version anterior\n", int(name.size()), name.data());
+      return false;
+   }
+
+   for (TextureHandle handle : handles){
+      Texture* texture = textures.get(handle);
+
+      glBindTexture(GL_TEXTURE_2D, texture->texture);
+      totalBytes -= texture->bytes;
+      texture->bytes = upload(image, texture->options);
+      totalBytes += texture->bytes;
+      texture->width = image.width;
+      texture->height = image.height;
+      texture->fromFile = true;
+
+      //El contenido ha cambiado, la textura se busca por el hash nuevo
+      HashMap<uint64_t, TextureHandle>::iterator previous = byContent.find(texture->contentKey);
+      if (previous != byContent.end() && previous->second == handle)
+         byContent.erase(previous);
+
+      texture->contentKey = contentHash(image, texture->options);
+      byContent.insert(texture->contentKey, handle);
+   }
+
+   return true;
+}
+
+void TextureManager::clear(){
+   for (const Texture& texture : textures)
+      glDeleteTextures(1, &texture.texture);
+
+   textures.clear();
+   byName.clear();
+   byContent.clear();
+   byTexture.clear();
+   totalBytes = 0;
+}
+
+void TextureManager::printReport(FILE* file) const{
+   fprintf(file, "Texturas: %zu, %.1f KiB\n", textures.size(), double(totalBytes) / 1024.0);
+
+   static const char* formats[] = { "RGBA", "RGB" };
+   static const char* filters[] = { "nearest", "linear" };
+   for (const Texture& texture : textures){
+      fprintf(file, "  %-32s %5ux%-5u %-4s %-7s %-6s %3u refs %9.1f KiB\n", texture.name.c_str(), texture.width, texture.height,
+              formats[texture.options.format], filters[texture.options.filter], texture.options.mipmaps ? "mips" : "", texture.references,
+              double(texture.bytes) / 1024.0);
+   }
+}
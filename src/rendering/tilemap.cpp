@@ -0,0 +1,113 @@
+#include "include/rendering/tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+Tilemap::Tilemap(uint32_t width, uint32_t height, float tileSize, glm::vec2 origin): width(width), height(height), tileSize(tileSize), origin(origin){
+   chunkColumns = (width + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+   chunkRows = (height + TILEMAP_CHUNK_SIZE - 1) / TILEMAP_CHUNK_SIZE;
+
+   //Los tiles que sobran en los chunks del borde se quedan vacios para siempre
+   tiles.assign(size_t(chunkColumns) * chunkRows * TILEMAP_CHUNK_TILES, TILE_EMPTY);
+   //Empiezan en 1, un renderizador sin nada construido tiene la revision 0
+   revisions.assign(size_t(chunkColumns) * chunkRows, 1);
+}
+
+//Primero el chunk y luego la posicion dentro de el
+size_t Tilemap::tileIndex(uint32_t x, uint32_t y) const{
+   size_t chunk = size_t(y / TILEMAP_CHUNK_SIZE) * chunkColumns + x / TILEMAP_CHUNK_SIZE;
+   return chunk * TILEMAP_CHUNK_TILES + (y % TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + x % TILEMAP_CHUNK_SIZE;
+}
+
+uint16_t Tilemap::getTile(uint32_t x, uint32_t y) const{
+   if (x >= width || y >= height)
+      return TILE_EMPTY;
+
+   return tiles[tileIndex(x, y)];
+}
+
+void Tilemap::setTile(uint32_t x, uint32_t y, uint16_t tile){
+   if (x >= width || y >= height)
+      return;
+
+   //Poner el mismo tile no cuenta como cambio
+   uint16_t& current = tiles[tileIndex(x, y)];
+   if (current == tile)
+      return;
+
+   current = tile;
+   revisions[size_t(y / TILEMAP_CHUNK_SIZE) * chunkColumns + x / TILEMAP_CHUNK_SIZE]++;
+}
+
+void Tilemap::fill(uint16_t tile){
+   for (uint32_t y = 0; y < height; y++){
+      for (uint32_t x = 0; x < width; x++)
+         setTile(x, y, tile);
+   }
+}
+
+void Tilemap::setPalette(uint16_t tile, unsigned int texture){
+   if (tile == TILE_EMPTY)
+      return;
+
+   if (tile >= palette.size())
+      palette.resize(size_t(tile) + 1, 0);
+   palette[tile] = texture;
+}
+
+bool Tilemap::tileAt(glm::vec2 point, uint32_t& x, uint32_t& y) const{
+   float column = std::floor((point.x - origin.x) / tileSize);
+   float row = std::floor((point.y - origin.y) / tileSize);
+   if (column < 0 || row < 0 || column >= float(width) || row >= float(height))
+      return false;
+
+   x = uint32_t(column);
+   y = uint32_t(row);
+   return true;
+}
+
+glm::vec2 Tilemap::chunkOrigin(uint32_t chunkX, uint32_t chunkY) const{
+   float chunkSize = tileSize * float(TILEMAP_CHUNK_SIZE);
+   return origin + glm::vec2(float(chunkX) * chunkSize, float(chunkY) * chunkSize);
+}
+
+bool Tilemap::chunksInRect(glm::vec2 min, glm::vec2 max, uint32_t& x0, uint32_t& y0, uint32_t& x1, uint32_t& y1) const{
+   //Solo la parte con tiles de verdad, los chunks del borde no se estiran hasta el final
+   float chunkSize = tileSize * float(TILEMAP_CHUNK_SIZE);
+   glm::vec2 mapMax = origin + glm::vec2(float(width), float(height)) * tileSize;
+   if (max.x <= origin.x || max.y <= origin.y || min.x >= mapMax.x || min.y >= mapMax.y || min.x >= max.x || min.y >= max.y)
+      return false;
+
+   x0 = uint32_t(std::max(0.0f, std::floor((min.x - origin.x) / chunkSize)));
+   y0 = uint32_t(std::max(0.0f, std::floor((min.y - origin.y) / chunkSize)));
+   x1 = uint32_t(std::min(float(chunkColumns), std::ceil((max.x - origin.x) / chunkSize)));
+   y1 = uint32_t(std::min(float(chunkRows), std::ceil((max.y - origin.y) / chunkSize)));
+   return x0 < x1 && y0 < y1;
+}
+
+void Tilemap::buildChunk(uint32_t chunk, std::vector<TileInstance>& instances, std::vector<TileRange>& ranges) const{
+   instances.clear();
+   ranges.clear();
+
+   //Indice, fila y columna en una clave, al ordenar quedan juntos los tiles con el mismo indice
+   const uint16_t* chunkTiles = tiles.data() + size_t(chunk) * TILEMAP_CHUNK_TILES;
+   sortKeys.clear();
+   for (uint32_t i = 0; i < TILEMAP_CHUNK_TILES; i++){
+      if (chunkTiles[i] != TILE_EMPTY)
+         sortKeys.push_back(uint32_t(chunkTiles[i]) << 16 | i);
+   }
+
+   //Como mucho TILEMAP_CHUNK_TILES claves
+   std::sort(sortKeys.begin(), sortKeys.end());
+
+   for (uint32_t key : sortKeys){
+      uint16_t tile = uint16_t(key >> 16);
+      uint32_t i = key & 0xFFFF;
+
+      if (ranges.empty() || ranges.back().tile != tile)
+         ranges.push_back(TileRange{ tile, uint32_t(instances.size()), 0 });
+      ranges.back().count++;
+
+      instances.push_back(TileInstance{ uint16_t(i % TILEMAP_CHUNK_SIZE), uint16_t(i / TILEMAP_CHUNK_SIZE) });
+   }
+}
@@ -0,0 +1,163 @@
+#include "include/rendering/tilemapRenderer.h"
+
+#include <algorithm>
+#include <glad/glad.h>
+
+TilemapRenderer::TilemapRenderer(): maxRebuildsPerFrame(64), drawCalls(0), visibleChunks(0), culledChunks(0), rebuiltChunks(0),
+                                     shader(Shader::get("shader/shader.vs", "shader/shader.fs", "TILEMAP")), rebuildBudget(0){
+   //El mismo quad que los sprites, de -0.5 a 0.5
+   float vertices[] = {
+      0.5,  0.5, 1.0f, 1.0f,        // top right
+      0.5, -0.5, 1.0f, 0.0f,        // bottom right
+      -0.5, -0.5, 0.0f, 0.0f,       // bottom left
+      -0.5,  0.5, 0.0f, 1.0f        // top left
+   };
+
+   unsigned int indices[] = {
+      0, 1, 3,
+      1, 2, 3
+   };
+
+   glGenVertexArrays(1, &VAO);
+   glGenBuffers(1, &VBO);
+   glGenBuffers(1, &EBO);
+
+   glBindVertexArray(VAO);
+
+   glBindBuffer(GL_ARRAY_BUFFER, VBO);
+   glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 16, vertices, GL_STATIC_DRAW);
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+   glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+   glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+   glEnableVertexAttribArray(0);
+
+   glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+   glEnableVertexAttribArray(1);
+
+   //Por instancia: la posicion del tile dentro del chunk, el buffer cambia en cada chunk
+   glEnableVertexAttribArray(2);
+   glVertexAttribDivisor(2, 1);
+
+   glBindVertexArray(0);
+
+   shader.bindUniformBlock("Projection", PROJECTION_BINDING);
+   updateUniformLocations();
+}
+
+TilemapRenderer::~TilemapRenderer(){
+   while (!maps.empty())
+      forget(*maps.back().first);
+
+   glDeleteBuffers(1, &VBO);
+   glDeleteBuffers(1, &EBO);
+   glDeleteVertexArrays(1, &VAO);
+}
+
+//Las posiciones cambian si el shader se ha recargado
+void TilemapRenderer::updateUniformLocations(){
+   chunkOriginLoc = glGetUniformLocation(shader.ID, "chunkOrigin");
+   tileSizeLoc = glGetUniformLocation(shader.ID, "tileSize");
+   shaderGeneration = shader.generation;
+}
+
+std::vector<TilemapRenderer::ChunkMesh>& TilemapRenderer::meshesOf(const Tilemap& map){
+   for (std::pair<const Tilemap*, std::vector<ChunkMesh>>& entry : maps){
+      if (entry.first == &map)
+         return entry.second;
+   }
+
+   //Los buffers se crean la primera vez que se ve cada chunk
+   maps.push_back(std::make_pair(&map, std::vector<ChunkMesh>(map.chunkCount(), ChunkMesh{ 0, 0, {} })));
+   return maps.back().second;
+}
+
+void TilemapRenderer::forget(const Tilemap& map){
+   for (size_t i = 0; i < maps.size(); i++){
+      if (maps[i].first != &map)
+         continue;
+
+      for (ChunkMesh& mesh : maps[i].second){
+         if (mesh.buffer != 0)
+            glDeleteBuffers(1, &mesh.buffer);
+      }
+
+      maps.erase(maps.begin() + i);
+      return;
+   }
+}
+
+void TilemapRenderer::beginFrame(){
+   drawCalls = 0;
+   visibleChunks = 0;
+   culledChunks = 0;
+   rebuiltChunks = 0;
+   rebuildBudget = maxRebuildsPerFrame;
+}
+
+void TilemapRenderer::rebuild(const Tilemap& map, uint32_t chunk, ChunkMesh& mesh){
+   map.buildChunk(chunk, instances, mesh.ranges);
+
+   if (mesh.buffer == 0)
+      glGenBuffers(1, &mesh.buffer);
+
+   glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
+   glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(TileInstance), instances.data(), GL_STATIC_DRAW);
+
+   mesh.revision = map.chunkRevision(chunk);
+   rebuiltChunks++;
+}
+
+void TilemapRenderer::render(const Tilemap& map, glm::vec2 viewMin, glm::vec2 viewMax){
+   uint32_t x0, y0, x1, y1;
+   if (!map.chunksInRect(viewMin, viewMax, x0, y0, x1, y1)){
+      culledChunks += map.chunkCount();
+      return;
+   }
+   culledChunks += map.chunkCount() - (x1 - x0) * (y1 - y0);
+
+   if (shaderGeneration != shader.generation)
+      updateUniformLocations();
+
+   std::vector<ChunkMesh>& meshes = meshesOf(map);
+
+   shader.use();
+   glUniform1f(tileSizeLoc, map.getTileSize());
+   glBindVertexArray(VAO);
+
+   for (uint32_t chunkY = y0; chunkY < y1; chunkY++){
+      for (uint32_t chunkX = x0; chunkX < x1; chunkX++){
+         uint32_t chunk = chunkY * map.chunksX() + chunkX;
+         ChunkMesh& mesh = meshes[chunk];
+         visibleChunks++;
+
+         if (mesh.revision != map.chunkRevision(chunk) && (mesh.buffer == 0 || rebuildBudget > 0)){
+            if (mesh.buffer != 0)
+               rebuildBudget--;
+            rebuild(map, chunk, mesh);
+         }
+
+         if (mesh.ranges.empty())
+            continue;
+
+         glm::vec2 origin = map.chunkOrigin(chunkX, chunkY);
+         glUniform2f(chunkOriginLoc, origin.x, origin.y);
+         glBindBuffer(GL_ARRAY_BUFFER, mesh.buffer);
+
+         //GL 3.3 no tiene base instance, cada rango mueve el inicio del atributo
+         for (const TileRange& range : mesh.ranges){
+            unsigned int texture = map.getPalette(range.tile);
+            if (texture == 0)
+               continue;
+
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glVertexAttribIPointer(2, 2, GL_UNSIGNED_SHORT, sizeof(TileInstance), (void*)(size_t(range.offset) * sizeof(TileInstance)));
+            glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, range.count);
+            drawCalls++;
+         }
+      }
+   }
+
+   glBindVertexArray(0);
+}
@@ -0,0 +1,302 @@
+#include "include/rendering/transformKernel.h"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//AVX se compila aparte con target("avx") y se elige al ejecutar, asi el binario sigue funcionando sin AVX
+#if defined(__SSE2__) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRANSFORM_KERNEL_AVX
+#include <immintrin.h>
+#endif
+
+static const float DEGREES_TO_RADIANS = 0.017453292519943295f;
+//Las rotaciones se recortan a esto antes de pasar el cuadrante a entero, asi siempre cabe en un int
+//NaN se queda en -MAX_ROTATION igual que hacen _mm_max_ps y _mm256_max_ps, todas las versiones dan la misma matriz
+static const float MAX_ROTATION = 1e8f;
+static const float TWO_OVER_PI = 0.6366197723675814f;
+
+//pi/2 partido en tres para que la reduccion de rango sea exacta (Cody-Waite, constantes de cephes)
+static const float HALF_PI_1 = 1.5703125f;
+static const float HALF_PI_2 = 4.837512969970703125e-4f;
+static const float HALF_PI_3 = 7.54978995489188216e-8f;
+
+//Polinomios de seno y coseno para |r| <= pi/4 (cephes sinf/cosf)
+static const float SIN_1 = -1.6666654611e-1f;
+static const float SIN_2 = 8.3321608736e-3f;
+static const float SIN_3 = -1.9515295891e-4f;
+static const float COS_1 = 4.166664568298827e-2f;
+static const float COS_2 = -1.388731625493765e-3f;
+static const float COS_3 = 2.443315711809948e-5f;
+
+//Version escalar, da lo mismo que las vectoriales
+static void sinCos(float degrees, float& sine, float& cosine){
+   degrees = degrees > -MAX_ROTATION ? degrees : -MAX_ROTATION;
+   degrees = degrees < MAX_ROTATION ? degrees : MAX_ROTATION;
+   float x = degrees * DEGREES_TO_RADIANS;
+   float q = std::nearbyint(x * TWO_OVER_PI);
+   int quadrant = int(q);
+
+   float r = ((x - q * HALF_PI_1) - q * HALF_PI_2) - q * HALF_PI_3;
+   float r2 = r * r;
+
+   float s = r + r * r2 * (SIN_1 + r2 * (SIN_2 + r2 * SIN_3));
+   float c = 1.0f - 0.5f * r2 + r2 * r2 * (COS_1 + r2 * (COS_2 + r2 * COS_3));
+
+   //Cada cuadrante intercambia y/o cambia de signo el seno y el coseno
+   if (quadrant & 1){
+      float swap = s;
+      s = c;
+      c = swap;
+   }
+
+   sine = (quadrant & 2) ? -s : s;
+   cosine = ((quadrant + 1) & 2) ? -c : c;
+}
+
+static void buildScalar(const glm::vec2* positions, const glm::vec2* scales, const float* rotations, Affine2D* out, size_t count){
+   for (size_t i = 0; i < count; i++){
+      float s, c;
+      sinCos(rotations[i], s, c);
+
+      out[i] = Affine2D{ c * scales[i].x, s * scales[i].x, -s * scales[i].y, c * scales[i].y, positions[i].x, positions[i].y };
+   }
+}
+
+#if defined(__SSE2__)
+//Pasa de un registro por campo a 4 matrices seguidas (24 floats)
+static inline void store4(float* out, __m128 ax, __m128 ay, __m128 bx, __m128 by, __m128 tx, __m128 ty){
+   __m128 aLow = _mm_unpacklo_ps(ax, ay);
+   __m128 bLow = _mm_unpacklo_ps(bx, by);
+   __m128 tLow = _mm_unpacklo_ps(tx, ty);
+   __m128 aHigh = _mm_unpackhi_ps(ax, ay);
+   __m128 bHigh = _mm_unpackhi_ps(bx, by);
+   __m128 tHigh = _mm_unpackhi_ps(tx, ty);
+
+   _mm_storeu_ps(out + 0, _mm_movelh_ps(aLow, bLow));
+   _mm_storeu_ps(out + 4, _mm_shuffle_ps(tLow, aLow, _MM_SHUFFLE(3, 2, 1, 0)));
+   _mm_storeu_ps(out + 8, _mm_shuffle_ps(bLow, tLow, _MM_SHUFFLE(3, 2, 3, 2)));
+   _mm_storeu_ps(out + 12, _mm_movelh_ps(aHigh, bHigh));
+   _mm_storeu_ps(out + 16, _mm_shuffle_ps(tHigh, aHigh, _MM_SHUFFLE(3, 2, 1, 0)));
+   _mm_storeu_ps(out + 20, _mm_shuffle_ps(bHigh, tHigh, _MM_SHUFFLE(3, 2, 3, 2)));
+}
+
+static void buildSSE(const glm::vec2* positions, const glm::vec2* scales, const float* rotations, Affine2D* out, size_t count){
+   const float* position = &positions[0].x;
+   const float* scale = &scales[0].x;
+   float* result = &out[0].a;
+
+   const __m128 signBit = _mm_set1_ps(-0.0f);
+   const __m128i one = _mm_set1_epi32(1);
+   const __m128i two = _mm_set1_epi32(2);
+
+   size_t i = 0;
+   for (; i + 4 <= count; i += 4){
+      //x e y vienen intercalados, se separan
+      __m128 p01 = _mm_loadu_ps(position + 2 * i);
+      __m128 p23 = _mm_loadu_ps(position + 2 * i + 4);
+      __m128 tx = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 ty = _mm_shuffle_ps(p01, p23, _MM_SHUFFLE(3, 1, 3, 1));
+
+      __m128 s01 = _mm_loadu_ps(scale + 2 * i);
+      __m128 s23 = _mm_loadu_ps(scale + 2 * i + 4);
+      __m128 sx = _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 sy = _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(3, 1, 3, 1));
+
+      //Reduccion de rango
+      __m128 degrees = _mm_max_ps(_mm_loadu_ps(rotations + i), _mm_set1_ps(-MAX_ROTATION));
+      degrees = _mm_min_ps(degrees, _mm_set1_ps(MAX_ROTATION));
+      __m128 x = _mm_mul_ps(degrees, _mm_set1_ps(DEGREES_TO_RADIANS));
+      __m128i quadrant = _mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(TWO_OVER_PI)));
+      __m128 q = _mm_cvtepi32_ps(quadrant);
+
+      __m128 r = _mm_sub_ps(x, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_1)));
+      r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_2)));
+      r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(HALF_PI_3)));
+      __m128 r2 = _mm_mul_ps(r, r);
+
+      __m128 s = _mm_add_ps(_mm_set1_ps(SIN_2), _mm_mul_ps(r2, _mm_set1_ps(SIN_3)));
+      s = _mm_add_ps(_mm_set1_ps(SIN_1), _mm_mul_ps(r2, s));
+      s = _mm_add_ps(r, _mm_mul_ps(_mm_mul_ps(r, r2), s));
+
+      __m128 c = _mm_add_ps(_mm_set1_ps(COS_2), _mm_mul_ps(r2, _mm_set1_ps(COS_3)));
+      c = _mm_add_ps(_mm_set1_ps(COS_1), _mm_mul_ps(r2, c));
+      c = _mm_add_ps(_mm_sub_ps(_mm_set1_ps(1.0f), _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_mul_ps(_mm_mul_ps(r2, r2), c));
+
+      //Cuadrantes impares intercambian seno y coseno
+      __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+      __m128 difference = _mm_and_ps(_mm_xor_ps(s, c), swap);
+      __m128 sine = _mm_xor_ps(s, difference);
+      __m128 cosine = _mm_xor_ps(c, difference);
+
+      //El bit 1 del cuadrante (y del cuadrante + 1 para el coseno) es el signo
+      __m128 sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+      __m128 cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+      sine = _mm_xor_ps(sine, sineSign);
+      cosine = _mm_xor_ps(cosine, cosineSign);
+
+      __m128 ax = _mm_mul_ps(cosine, sx);
+      __m128 ay = _mm_mul_ps(sine, sx);
+      __m128 bx = _mm_xor_ps(_mm_mul_ps(sine, sy), signBit);
+      __m128 by = _mm_mul_ps(cosine, sy);
+
+      store4(result + 6 * i, ax, ay, bx, by, tx, ty);
+   }
+
+   buildScalar(positions + i, scales + i, rotations + i, out + i, count - i);
+}
+#endif
+
+#if defined(TRANSFORM_KERNEL_AVX)
+//Igual que store4 pero con 8 matrices, las operaciones de AVX van por mitades de 128 bits
+__attribute__((target("avx")))
+static inline void store8(float* out, __m256 ax, __m256 ay, __m256 bx, __m256 by, __m256 tx, __m256 ty){
+   __m256 aLow = _mm256_unpacklo_ps(ax, ay);
+   __m256 bLow = _mm256_unpacklo_ps(bx, by);
+   __m256 tLow = _mm256_unpacklo_ps(tx, ty);
+   __m256 aHigh = _mm256_unpackhi_ps(ax, ay);
+   __m256 bHigh = _mm256_unpackhi_ps(bx, by);
+   __m256 tHigh = _mm256_unpackhi_ps(tx, ty);
+
+   //Cada mitad tiene lo de store4 para los sprites 0-3 (abajo) y 4-7 (arriba)
+   __m256 r0 = _mm256_shuffle_ps(aLow, bLow, _MM_SHUFFLE(1, 0, 1, 0));
+   __m256 r1 = _mm256_shuffle_ps(tLow, aLow, _MM_SHUFFLE(3, 2, 1, 0));
+   __m256 r2 = _mm256_shuffle_ps(bLow, tLow, _MM_SHUFFLE(3, 2, 3, 2));
+   __m256 r3 = _mm256_shuffle_ps(aHigh, bHigh, _MM_SHUFFLE(1, 0, 1, 0));
+   __m256 r4 = _mm256_shuffle_ps(tHigh, aHigh, _MM_SHUFFLE(3, 2, 1, 0));
+   __m256 r5 = _mm256_shuffle_ps(bHigh, tHigh, _MM_SHUFFLE(3, 2, 3, 2));
+
+   _mm256_storeu_ps(out + 0, _mm256_permute2f128_ps(r0, r1, 0x20));
+   _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(r2, r3, 0x20));
+   _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(r4, r5, 0x20));
+   _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(r0, r1, 0x31));
+   _mm256_storeu_ps(out + 32, _mm256_permute2f128_ps(r2, r3, 0x31));
+   _mm256_storeu_ps(out + 40, _mm256_permute2f128_ps(r4, r5, 0x31));
+}
+
+//AVX sin AVX2 no tiene operaciones de enteros de 256 bits, el cuadrante se trata como float
+__attribute__((target("avx")))
+static void buildAVX(const glm::vec2* positions, const glm::vec2* scales, const float* rotations, Affine2D* out, size_t count){
+   const float* position = &positions[0].x;
+   const float* scale = &scales[0].x;
+   float* result = &out[0].a;
+
+   const __m256 signBit = _mm256_set1_ps(-0.0f);
+   const __m256 one = _mm256_set1_ps(1.0f);
+   const __m256 two = _mm256_set1_ps(2.0f);
+
+   size_t i = 0;
+   for (; i + 8 <= count; i += 8){
+      //Sprites 0,1,4,5 en a y 2,3,6,7 en b, asi al separar x e y quedan en orden
+      const float* p = position + 2 * i;
+      __m256 pa = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 8), 1);
+      __m256 pb = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p + 4)), _mm_loadu_ps(p + 12), 1);
+      __m256 tx = _mm256_shuffle_ps(pa, pb, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 ty = _mm256_shuffle_ps(pa, pb, _MM_SHUFFLE(3, 1, 3, 1));
+
+      const float* e = scale + 2 * i;
+      __m256 ea = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(e)), _mm_loadu_ps(e + 8), 1);
+      __m256 eb = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(e + 4)), _mm_loadu_ps(e + 12), 1);
+      __m256 sx = _mm256_shuffle_ps(ea, eb, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 sy = _mm256_shuffle_ps(ea, eb, _MM_SHUFFLE(3, 1, 3, 1));
+
+      __m256 degrees = _mm256_max_ps(_mm256_loadu_ps(rotations + i), _mm256_set1_ps(-MAX_ROTATION));
+      degrees = _mm256_min_ps(degrees, _mm256_set1_ps(MAX_ROTATION));
+      __m256 x = _mm256_mul_ps(degrees, _mm256_set1_ps(DEGREES_TO_RADIANS));
+      __m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(TWO_OVER_PI)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+
+      __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(HALF_PI_1)));
+      r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(HALF_PI_2)));
+      r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(HALF_PI_3)));
+      __m256 r2 = _mm256_mul_ps(r, r);
+
+      __m256 s = _mm256_add_ps(_mm256_set1_ps(SIN_2), _mm256_mul_ps(r2, _mm256_set1_ps(SIN_3)));
+      s = _mm256_add_ps(_mm256_set1_ps(SIN_1), _mm256_mul_ps(r2, s));
+      s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+
+      __m256 c = _mm256_add_ps(_mm256_set1_ps(COS_2), _mm256_mul_ps(r2, _mm256_set1_ps(COS_3)));
+      c = _mm256_add_ps(_mm256_set1_ps(COS_1), _mm256_mul_ps(r2, c));
+      c = _mm256_add_ps(_mm256_sub_ps(one, _mm256_mul_ps(_mm256_set1_ps(0.5f), r2)), _mm256_mul_ps(_mm256_mul_ps(r2, r2), c));
+
+      //Cuadrante modulo 4 (0..3) con floats
+      __m256 quadrant = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_set1_ps(4.0f), _mm256_floor_ps(_mm256_mul_ps(q, _mm256_set1_ps(0.25f)))));
+
+      __m256 odd = _mm256_sub_ps(quadrant, _mm256_mul_ps(two, _mm256_floor_ps(_mm256_mul_ps(quadrant, _mm256_set1_ps(0.5f)))));
+      __m256 swap = _mm256_cmp_ps(odd, one, _CMP_EQ_OQ);
+      __m256 difference = _mm256_and_ps(_mm256_xor_ps(s, c), swap);
+      __m256 sine = _mm256_xor_ps(s, difference);
+      __m256 cosine = _mm256_xor_ps(c, difference);
+
+      //Seno negativo en los cuadrantes 2 y 3, coseno en el 1 y el 2
+      __m256 sineNegative = _mm256_cmp_ps(quadrant, two, _CMP_GE_OQ);
+      __m256 cosineNegative = _mm256_and_ps(_mm256_cmp_ps(quadrant, one, _CMP_GE_OQ), _mm256_cmp_ps(quadrant, two, _CMP_LE_OQ));
+      sine = _mm256_xor_ps(sine, _mm256_and_ps(sineNegative, signBit));
+      cosine = _mm256_xor_ps(cosine, _mm256_and_ps(cosineNegative, signBit));
+
+      __m256 ax = _mm256_mul_ps(cosine, sx);
+      __m256 ay = _mm256_mul_ps(sine, sx);
+      __m256 bx = _mm256_xor_ps(_mm256_mul_ps(sine, sy), signBit);
+      __m256 by = _mm256_mul_ps(cosine, sy);
+
+      store8(result + 6 * i, ax, ay, bx, by, tx, ty);
+   }
+
+   buildSSE(positions + i, scales + i, rotations + i, out + i, count - i);
+}
+#endif
+
+bool transformKernelAvailable(TRANSFORM_KERNEL kernel){
+   switch (kernel){
+      case kernelAuto:
+      case kernelScalar:
+         return true;
+#if defined(__SSE2__)
+      case kernelSSE:
+         return true;
+#endif
+#if defined(TRANSFORM_KERNEL_AVX)
+      case kernelAVX:
+         return __builtin_cpu_supports("avx");
+#endif
+      default:
+         return false;
+   }
+}
+
+TRANSFORM_KERNEL bestTransformKernel(){
+   static const TRANSFORM_KERNEL best = transformKernelAvailable(kernelAVX) ? kernelAVX : transformKernelAvailable(kernelSSE) ? kernelSSE : kernelScalar;
+   return best;
+}
+
+const char* transformKernelName(TRANSFORM_KERNEL kernel){
+   switch (kernel){
+      case kernelScalar: return "scalar";
+      case kernelSSE: return "sse";
+      case kernelAVX: return "avx";
+      default: return "auto";
+   }
+}
+
+void buildTransforms(const glm::vec2* positions, const glm::vec2* scales, const float* rotations, Affine2D* out, size_t count, TRANSFORM_KERNEL kernel){
+   if (kernel == kernelAuto || !transformKernelAvailable(kernel))
+      kernel = bestTransformKernel();
+
+   switch (kernel){
+#if defined(TRANSFORM_KERNEL_AVX)
+      case kernelAVX:
+         buildAVX(positions, scales, rotations, out, count);
+         return;
+#endif
+#if defined(__SSE2__)
+      case kernelSSE:
+         buildSSE(positions, scales, rotations, out, count);
+         return;
+#endif
+      default:
+         buildScalar(positions, scales, rotations, out, count);
+         return;
+   }
+}
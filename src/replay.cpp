@@ -0,0 +1,142 @@
+#include "include/replay.h"
+#include "include/simulation.h"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static void writeVarint(std::vector<uint8_t>& data, uint64_t value){
+   while (value >= 0x80){
+      data.push_back(uint8_t(value) | 0x80);
+      value >>= 7;
+   }
+   data.push_back(uint8_t(value));
+}
+
+//Devuelve false si el varint se sale de los datos
+static bool readVarint(const std::vector<uint8_t>& data, size_t& position, uint64_t& value){
+   value = 0;
+   for (int shift = 0; shift < 64 && position < data.size(); shift += 7){
+      uint8_t byte = data[position++];
+      value |= uint64_t(byte & 0x7F) << shift;
+
+      if (!(byte & 0x80))
+         return true;
+   }
+
+   return false;
+}
+
+//Empieza a grabar una partida nueva
+void ReplayRecorder::start(uint64_t seed){
+   data.clear();
+   data.push_back('T');
+   data.push_back('R');
+   data.push_back('P');
+   data.push_back('L');
+   writeVarint(data, REPLAY_VERSION);
+   writeVarint(data, Simulation::tickRate);
+   writeVarint(data, seed);
+
+   lastTick = 0;
+   recording = true;
+}
+
+//Apunta el input que se aplica en el tick, los ticks sin input no ocupan nada
+void ReplayRecorder::record(uint64_t tick, INPUT input){
+   if (!recording || input == inputNone)
+      return;
+
+   writeVarint(data, ((tick - lastTick) << 3) | input);
+   lastTick = tick;
+}
+
+//Cierra la repeticion con el resultado de la partida y la escribe
+bool ReplayRecorder::finish(const Simulation& simulation){
+   if (!recording)
+      return false;
+
+   recording = false;
+
+   writeVarint(data, ((simulation.state.ticks - lastTick) << 3) | REPLAY_END);
+   writeVarint(data, simulation.state.points);
+   writeVarint(data, simulation.state.board.hash());
+
+   std::ofstream file(path, std::ios::binary);
+   if (!file)
+      return false;
+
+   file.write((const char*)data.data(), data.size());
+   return bool(file);
+}
+
+//Carga una repeticion, devuelve false si el archivo no es valido
+bool ReplayPlayer::load(const std::string& path){
+   std::ifstream file(path, std::ios::binary);
+   if (!file)
+      return false;
+
+   data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+   if (data.size() < 4 || data[0] != 'T' || data[1] != 'R' || data[2] != 'P' || data[3] != 'L')
+      return false;
+
+   size_t header = 4;
+   uint64_t version, tickRate;
+   if (!readVarint(data, header, version) || version != REPLAY_VERSION)
+      return false;
+   if (!readVarint(data, header, tickRate) || tickRate != Simulation::tickRate)
+      return false;
+   if (!readVarint(data, header, seed))
+      return false;
+
+   eventsStart = header;
+
+   //Busca el final para saber cuantos ticks dura y el resultado esperado
+   rewind();
+   while (nextInputToPlay != INPUT(REPLAY_END))
+      readEvent();
+   endTick = nextTick;
+
+   uint64_t value;
+   if (!readVarint(data, position, value))
+      return false;
+   points = int(value);
+   if (!readVarint(data, position, boardHash))
+      return false;
+
+   rewind();
+   return true;
+}
+
+//Vuelve al principio de la repeticion
+void ReplayPlayer::rewind(){
+   position = eventsStart;
+   nextTick = 0;
+   readEvent();
+}
+
+//Lee el siguiente evento, si los datos se acaban se trata como el final
+void ReplayPlayer::readEvent(){
+   uint64_t value;
+   if (!readVarint(data, position, value)){
+      position = data.size() + 1;
+      nextInputToPlay = INPUT(REPLAY_END);
+      return;
+   }
+
+   nextTick += value >> 3;
+   nextInputToPlay = INPUT(value & 7);
+}
+
+INPUT ReplayPlayer::nextInput(const Simulation& simulation){
+   if (nextInputToPlay == INPUT(REPLAY_END) || simulation.state.ticks != nextTick)
+      return inputNone;
+
+   INPUT input = nextInputToPlay;
+   readEvent();
+
+   return input;
+}
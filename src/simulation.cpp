@@ -0,0 +1,173 @@
+#include "include/simulation.h"
+#include "include/board.h"
+#include "include/movingPiece.h"
+#include "include/piece.h"
+
+//Crea la simulacion con la semilla que decide las piezas
+Simulation::Simulation(uint64_t seed){
+   reset(seed);
+}
+
+//Vuelve a empezar la partida
+void Simulation::reset(uint64_t seed){
+   state.seed = seed;
+   state.random = Random(seed);
+   state.board.reset();
+
+   state.points = 0;
+   state.piecesPlaced = 0;
+   state.linesCleared = 0;
+   state.ticks = 0;
+   state.isOver = false;
+
+   state.moveCooldown = 0;
+   state.rotateCooldown = 0;
+   state.fallTimer = 0;
+
+   state.nextPiece = MovingPiece(state.random);
+
+   spawnPiece();
+}
+
+//Avanza un tick aplicando la accion del jugador
+void Simulation::tick(INPUT input){
+   if (state.isOver)
+      return;
+
+   state.ticks++;
+
+   if (state.moveCooldown > 0)
+      state.moveCooldown--;
+   if (state.rotateCooldown > 0)
+      state.rotateCooldown--;
+
+   MovingPiece& movingPiece = state.movingPiece;
+   int fallTicks = FALL_TICKS;
+
+   switch (input) {
+      case inputLeft:
+         if (state.moveCooldown == 0 && isValidMove(movingPiece.currentX - 1, movingPiece.currentY, movingPiece)){
+            movingPiece.moveLeft();
+            state.moveCooldown = MOVE_COOLDOWN_TICKS;
+         }
+      break;
+      case inputRight:
+         if (state.moveCooldown == 0 && isValidMove(movingPiece.currentX + 1, movingPiece.currentY, movingPiece)){
+            movingPiece.moveRigth();
+            state.moveCooldown = MOVE_COOLDOWN_TICKS;
+         }
+      break;
+      case inputRotate:
+         if (state.rotateCooldown == 0 && movingPiece.rotateLeft(state.board.pieces))
+            state.rotateCooldown = ROTATE_COOLDOWN_TICKS;
+      break;
+      case inputSoftDrop:
+         fallTicks = 1;
+      break;
+      case inputHardDrop:
+         movingPiece.moveDown(&state.board);
+         placePiece();
+         state.fallTimer = 0;
+      return;
+      case inputNone:
+      break;
+   }
+
+   //El bucle de movimiento
+   state.fallTimer++;
+   if (state.fallTimer >= fallTicks){
+      movePiece();
+      state.fallTimer = 0;
+   }
+}
+
+//Mueve la pieza hacia abajo
+void Simulation::movePiece(){
+   MovingPiece& movingPiece = state.movingPiece;
+
+   if (!isValidMove(movingPiece.currentX, movingPiece.currentY + 1, movingPiece)){
+      placePiece();
+      return;
+   }
+
+   //Baja la pieza una casilla
+   movingPiece.currentY++;
+
+   //Si ya no puede bajar mas se hace estatica
+   if (!isValidMove(movingPiece.currentX, movingPiece.currentY + 1, movingPiece))
+      placePiece();
+}
+
+//Poner una pieza en su lugar
+void Simulation::placePiece(){
+   MovingPiece& movingPiece = state.movingPiece;
+
+   //Detectar si has perdido
+   if (movingPiece.currentY <= movingPiece.size){
+      state.isOver = true;
+      return;
+   }
+
+   //Fijar las casillas en el tablero
+   for (int i = 0; i < movingPiece.size; i++){
+      for (int j = 0; j < movingPiece.size; j++){
+         if (movingPiece.cell(i, j)){
+            state.board.lockCell(movingPiece.currentX + i, movingPiece.currentY + j, movingPiece.color);
+         }
+      }
+   }
+
+   //Comprobar eliminar piezas 
+   for (int j = 0; j < 20; j++){
+      bool hasToDelete = true;
+      for(int i = 0; i < 10; i++){
+         if (state.board.pieces[i][j].color == empty){
+            hasToDelete = false;
+            break;
+         }
+      }
+
+      if (hasToDelete){
+         deleteRow(j);
+         state.points += 5;
+      }
+   }
+
+   state.piecesPlaced++;
+
+   spawnPiece();
+}
+
+//Elimina una fila
+void Simulation::deleteRow(int row){
+   state.board.clearRow(row);
+   state.linesCleared++;
+}
+
+//La pieza siguiente pasa a ser la actual y se genera otra nueva
+void Simulation::spawnPiece(){
+   state.movingPiece = state.nextPiece;
+   state.nextPiece = MovingPiece(state.random);
+}
+
+bool Simulation::isValidMove(int newX, int newY, const MovingPiece& piece) const{
+   for(int i = 0; i < piece.size; i++){
+      for (int j = 0; j < piece.size; j++){
+         if (piece.cell(i, j)){
+            if (newX + i > 9 || newX + i < 0){
+               return false;
+            }
+
+            if (newY + j > 19){
+               return false;
+            }
+
+            if (state.board.pieces[newX + i][newY + j].color != empty){
+               return false;
+            }
+         }
+      }
+   }
+   
+   return true;
+}
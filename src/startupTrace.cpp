@@ -0,0 +1,110 @@
+#include "include/startupTrace.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+struct PhaseTime{
+   const char* name;
+   unsigned int calls;
+   uint64_t nanoseconds;
+   uint64_t selfNanoseconds;
+};
+
+static std::atomic<bool> traceRunning(false);
+static uint64_t traceStart = 0;
+static std::string reportPath;
+static std::mutex phasesMutex;
+//En el orden en que acaban por primera vez, son pocas y se buscan por nombre
+static std::vector<PhaseTime> phases;
+
+//La fase abierta en este hilo, para descontarle el tiempo de las de dentro
+static thread_local StartupPhase* currentPhase = nullptr;
+
+static uint64_t now(){
+   return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void StartupTrace::start(){
+   traceStart = now();
+}
+
+void StartupTrace::enable(const std::string& path){
+   reportPath = path;
+   traceRunning.store(true, std::memory_order_release);
+}
+
+bool StartupTrace::running(){
+   return traceRunning.load(std::memory_order_acquire);
+}
+
+void StartupTrace::record(const char* phase, uint64_t nanoseconds, uint64_t selfNanoseconds){
+   std::lock_guard<std::mutex> lock(phasesMutex);
+
+   for (PhaseTime& time : phases){
+      if (strcmp(time.name, phase) == 0){
+         time.calls++;
+         time.nanoseconds += nanoseconds;
+         time.selfNanoseconds += selfNanoseconds;
+         return;
+      }
+   }
+
+   phases.push_back(PhaseTime{ phase, 1, nanoseconds, selfNanoseconds });
+}
+
+bool StartupTrace::finish(){
+   if (!traceRunning.exchange(false))
+      return false;
+
+   uint64_t total = now() - traceStart;
+
+   std::lock_guard<std::mutex> lock(phasesMutex);
+   FILE* file = reportPath == "-" ? stdout : fopen(reportPath.c_str(), "w");
+   if (file == nullptr)
+      return false;
+
+   //Una fase por linea, asi StartupBench lo puede leer sin un parser de JSON
+   uint64_t accounted = 0;
+   fprintf(file, "{\n  \"version\": 1,\n  \"totalMs\": %.3f,\n  \"phases\": [\n", double(total) / 1e6);
+   for (size_t i = 0; i < phases.size(); i++){
+      const PhaseTime& time = phases[i];
+      fprintf(file, "    {\"name\": \"%s\", \"calls\": %u, \"ms\": %.3f, \"selfMs\": %.3f}%s\n", time.name, time.calls,
+              double(time.nanoseconds) / 1e6, double(time.selfNanoseconds) / 1e6, i + 1 < phases.size() ? "," : "");
+      accounted += time.selfNanoseconds;
+   }
+   fprintf(file, "  ],\n  \"otherMs\": %.3f\n}\n", double(total > accounted ? total - accounted : 0) / 1e6);
+
+   bool written = !ferror(file);
+   if (file != stdout)
+      written = fclose(file) == 0 && written;
+   else
+      fflush(file);
+
+   return written;
+}
+
+StartupPhase::StartupPhase(const char* name): name(name), parent(nullptr), begin(0), children(0), active(StartupTrace::running()){
+   if (!active)
+      return;
+
+   parent = currentPhase;
+   currentPhase = this;
+   begin = now();
+}
+
+void StartupPhase::end(){
+   if (!active)
+      return;
+   active = false;
+
+   uint64_t elapsed = now() - begin;
+   StartupTrace::record(name, elapsed, elapsed > children ? elapsed - children : 0);
+
+   currentPhase = parent;
+   if (parent != nullptr)
+      parent->children += elapsed;
+}
@@ -0,0 +1,86 @@
+#include "include/allocTracker.h"
+#include "include/bot.h"
+#include "include/random.h"
+#include "include/simulation.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//Comprueba que el bucle de la partida no reserva memoria: aparecer, rotar, mover y fijar piezas
+//Juega el bot y de vez en cuando se pulsa una tecla al azar, asi tambien hay rotaciones y movimientos que no caben
+//Sale con error si algun tick ha reservado algo
+int main(int argc, char* argv[]){
+   int pieces = 2000;
+   uint64_t seed = 1;
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--pieces") == 0 && i + 1 < argc){
+         pieces = atoi(argv[++i]);
+      }else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc){
+         seed = strtoull(argv[++i], nullptr, 10);
+      }else{
+         printf("Uso: %s [--pieces N] [--seed S]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   if (!AllocTracker::enabled()){
+      printf("Hace falta compilar con -DTETRIS_TRACK_ALLOCATIONS=ON\n");
+      return 1;
+   }
+
+   Simulation simulation(seed);
+   Bot bot;
+   Random random(seed);
+
+   int placed = 0;
+   uint64_t ticks = 0, spawns = 0, rotations = 0, moves = 0, games = 1;
+   uint64_t allocations = 0, bytes = 0, badTicks = 0;
+
+   while (placed < pieces){
+      if (simulation.state.isOver){
+         simulation.reset(random.next());
+         games++;
+      }
+
+      int before = simulation.state.piecesPlaced;
+
+      AllocTracker::beginFrame();
+      INPUT input = bot.nextInput(simulation);
+      if (random.range(0, 7) == 0)
+         input = INPUT(random.range(inputNone, inputSoftDrop));
+      simulation.tick(input);
+      AllocStats frame = AllocTracker::endFrame();
+
+      if (frame.allocations != 0){
+         if (badTicks == 0)
+            printf("El tick %llu ha reservado %llu veces (%llu bytes), entrada %d\n", (unsigned long long)ticks,
+                   (unsigned long long)frame.allocations, (unsigned long long)frame.bytes, int(input));
+         badTicks++;
+      }
+      allocations += frame.allocations;
+      bytes += frame.bytes;
+
+      if (input == inputRotate)
+         rotations++;
+      else if (input == inputLeft || input == inputRight)
+         moves++;
+
+      if (simulation.state.piecesPlaced != before){
+         placed++;
+         spawns++;
+      }
+      ticks++;
+   }
+
+   printf("%d piezas en %llu partidas, %llu ticks: %llu rotaciones y %llu movimientos pedidos, %llu piezas nuevas\n", pieces,
+          (unsigned long long)games, (unsigned long long)ticks, (unsigned long long)rotations, (unsigned long long)moves, (unsigned long long)spawns);
+   printf("Reservas: %llu (%llu bytes) en %llu ticks\n", (unsigned long long)allocations, (unsigned long long)bytes, (unsigned long long)badTicks);
+
+   if (allocations != 0){
+      AllocTracker::printReport(stdout);
+      return 1;
+   }
+
+   return 0;
+}
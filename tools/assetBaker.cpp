@@ -0,0 +1,192 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "include/rendering/stb_image.h"
+#include "include/rendering/bakedTexture.h"
+#include "include/assetPack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//Convierte las imagenes a .tex (RGBA ya volteado) para que el juego no tenga que descomprimirlas al arrancar
+//Cada .tex se escribe al lado de su imagen, el engine lo usa si existe
+//Con --pack junta todos los assets (las imagenes ya horneadas) en un solo archivo con indice
+
+static void printUsage(const char* program){
+   printf("Uso: %s [--mips] [imagen o carpeta]...\n", program);
+   printf("     %s [--mips] --pack assets.pak [--root carpeta]\n", program);
+   printf("  Sin rutas hornea ../assets/textures (desde la carpeta build)\n");
+   printf("  --mips  guarda tambien la cadena de mipmaps\n");
+   printf("  --pack  escribe el pack con las subcarpetas de --root (por defecto ../assets)\n");
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start){
+   return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool isImage(const std::filesystem::path& path){
+   std::string extension = path.extension().string();
+   return extension == ".png" || extension == ".jpg" || extension == ".bmp" || extension == ".tga";
+}
+
+//Lee el .tex recien escrito y lo copia entero, lo mismo que hara glTexImage2D al arrancar
+static double timeBakedLoad(const std::string& path, std::vector<uint8_t>& scratch){
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   BakedTexture baked;
+   if (!baked.load(path))
+      return -1;
+
+   for (uint32_t level = 0; level < baked.mipCount(); level++){
+      size_t bytes = size_t(baked.levelWidth(level)) * baked.levelHeight(level) * 4;
+      scratch.resize(bytes);
+      memcpy(scratch.data(), baked.levelData(level), bytes);
+   }
+
+   return secondsSince(start);
+}
+
+//Los archivos sueltos en la raiz (la captura del README) no son del juego, solo se empaquetan las subcarpetas
+static int writePack(const std::filesystem::path& root, const std::string& output, bool withMips){
+   std::vector<std::filesystem::path> files;
+   std::error_code error;
+   for (const std::filesystem::directory_entry& entry : std::filesystem::recursive_directory_iterator(root, error)){
+      if (!entry.is_regular_file() || !entry.path().lexically_relative(root).has_parent_path() || entry.path().extension() == ".tex")
+         continue;
+
+      files.push_back(entry.path());
+   }
+
+   if (error){
+      printf("No se puede leer %s\n", root.string().c_str());
+      return 1;
+   }
+
+   //Mismo orden siempre, para que el pack no cambie si no cambian los assets
+   std::sort(files.begin(), files.end());
+
+   stbi_set_flip_vertically_on_load(true);
+
+   AssetPackWriter writer;
+   size_t bytes = 0;
+   for (const std::filesystem::path& path : files){
+      std::string name = path.lexically_relative(root).generic_string();
+      std::vector<uint8_t> data;
+
+      if (isImage(path)){
+         int width, height, channels;
+         unsigned char* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, 4);
+         if (pixels == nullptr){
+            printf("  %-40s no se puede leer: %s\n", name.c_str(), stbi_failure_reason());
+            return 1;
+         }
+
+         data = bakeTexture(pixels, uint32_t(width), uint32_t(height), withMips);
+         stbi_image_free(pixels);
+      }else{
+         std::ifstream file(path, std::ios::binary);
+         data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      }
+
+      printf("  %-40s %9zu bytes\n", name.c_str(), data.size());
+      bytes += data.size();
+      writer.add(name, std::move(data));
+   }
+
+   if (!writer.write(output)){
+      printf("No se puede escribir %s\n", output.c_str());
+      return 1;
+   }
+
+   printf("%s: %zu assets, %zu bytes\n", output.c_str(), files.size(), bytes);
+   return 0;
+}
+
+int main(int argc, char* argv[]){
+   bool withMips = false;
+   std::string packPath;
+   std::filesystem::path root = "../assets";
+   std::vector<std::filesystem::path> inputs;
+
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--mips") == 0)
+         withMips = true;
+      else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+         packPath = argv[++i];
+      else if (strcmp(argv[i], "--root") == 0 && i + 1 < argc)
+         root = argv[++i];
+      else if (argv[i][0] == '-'){
+         printUsage(argv[0]);
+         return 1;
+      }else
+         inputs.push_back(argv[i]);
+   }
+
+   if (!packPath.empty())
+      return writePack(root, packPath, withMips);
+
+   if (inputs.empty())
+      inputs.push_back("../assets/textures");
+
+   std::vector<std::string> images;
+   for (const std::filesystem::path& input : inputs){
+      std::error_code error;
+      if (std::filesystem::is_directory(input, error)){
+         for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(input, error)){
+            if (entry.is_regular_file() && isImage(entry.path()))
+               images.push_back(entry.path().string());
+         }
+      }else if (std::filesystem::is_regular_file(input, error)){
+         images.push_back(input.string());
+      }else{
+         printf("No existe %s\n", input.string().c_str());
+         return 1;
+      }
+   }
+
+   //Igual que el engine: filas de abajo a arriba
+   stbi_set_flip_vertically_on_load(true);
+
+   double decodeSeconds = 0;
+   double loadSeconds = 0;
+   int failed = 0;
+   std::vector<uint8_t> scratch;
+
+   for (const std::string& image : images){
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+      int width, height, channels;
+      unsigned char* pixels = stbi_load(image.c_str(), &width, &height, &channels, 4);
+      double decoded = secondsSince(start);
+
+      if (pixels == nullptr){
+         printf("  %-40s no se puede leer: %s\n", image.c_str(), stbi_failure_reason());
+         failed++;
+         continue;
+      }
+
+      std::string output = bakedTexturePath(image);
+      bool written = writeBakedTexture(output, pixels, uint32_t(width), uint32_t(height), withMips);
+      stbi_image_free(pixels);
+
+      if (!written){
+         printf("  %-40s no se puede escribir %s\n", image.c_str(), output.c_str());
+         failed++;
+         continue;
+      }
+
+      double loaded = timeBakedLoad(output, scratch);
+      decodeSeconds += decoded;
+      loadSeconds += loaded;
+
+      printf("  %-40s %5dx%-5d stb %8.3f ms  .tex %8.3f ms\n", output.c_str(), width, height, decoded * 1e3, loaded * 1e3);
+   }
+
+   printf("%zu imagenes, %d errores: stb %.3f ms, .tex %.3f ms\n", images.size() - failed, failed, decodeSeconds * 1e3, loadSeconds * 1e3);
+   return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "include/myLibs/hashMap.h"
+#include "include/random.h"
+
+//Copia de la HashMap anterior (lista enlazada) para poder comparar
+template<typename K, typename D>
+class ListMap{
+public:
+    ListMap(): firstNode(nullptr){}
+
+    ~ListMap(){
+        while (firstNode != nullptr){
+            Node* next = firstNode->nextNode;
+            delete firstNode;
+            firstNode = next;
+        }
+    }
+
+    void AddNode(K key, D data){
+        Node* node = new Node{key, data, nullptr};
+        if (firstNode == nullptr){
+            firstNode = node;
+            return;
+        }
+
+        Node* currentNode = firstNode;
+        while (currentNode->nextNode != nullptr)
+            currentNode = currentNode->nextNode;
+
+        currentNode->nextNode = node;
+    }
+
+    D* find(const K& key){
+        for (Node* currentNode = firstNode; currentNode != nullptr; currentNode = currentNode->nextNode){
+            if (currentNode->key == key)
+                return &currentNode->data;
+        }
+
+        return nullptr;
+    }
+
+private:
+    struct Node{
+        K key;
+        D data;
+        Node* nextNode;
+    };
+
+    Node* firstNode;
+};
+
+struct Result{
+    double insertNs;
+    double hitNs;
+    double missNs;
+    uint64_t checksum;
+};
+
+static double nanosPer(std::chrono::steady_clock::time_point start, size_t operations){
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / double(operations);
+}
+
+//Cada mapa se usa igual: insertar n keys, buscar las que existen y buscar otras tantas que no
+template<typename Map, typename K, typename Insert, typename Find>
+static Result measure(const std::vector<K>& keys, const std::vector<K>& lookups, const std::vector<K>& misses, Insert insert, Find find){
+    Result result = {};
+    Map map;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < keys.size(); i++)
+        insert(map, keys[i], int(i));
+    result.insertNs = nanosPer(start, keys.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const K& key : lookups){
+        const int* value = find(map, key);
+        result.checksum += value != nullptr ? *value : 0;
+    }
+    result.hitNs = nanosPer(start, lookups.size());
+
+    start = std::chrono::steady_clock::now();
+    for (const K& key : misses)
+        result.checksum += find(map, key) != nullptr;
+    result.missNs = nanosPer(start, misses.size());
+
+    return result;
+}
+
+static void printRow(const char* name, const Result& result){
+    printf("  %-16s insert %9.1f ns  hit %9.1f ns  miss %9.1f ns  (checksum %llu)\n",
+           name, result.insertNs, result.hitNs, result.missNs, (unsigned long long)result.checksum);
+}
+
+template<typename K>
+static void run(const char* title, const std::vector<K>& keys, const std::vector<K>& misses, size_t lookupCount, bool includeList){
+    Random random(1234);
+    std::vector<K> lookups;
+    lookups.reserve(lookupCount);
+    for (size_t i = 0; i < lookupCount; i++)
+        lookups.push_back(keys[size_t(random.range(0, int(keys.size()) - 1))]);
+
+    std::vector<K> missLookups;
+    missLookups.reserve(lookupCount);
+    for (size_t i = 0; i < lookupCount; i++)
+        missLookups.push_back(misses[i % misses.size()]);
+
+    printf("%s (%zu keys, %zu lookups)\n", title, keys.size(), lookupCount);
+
+    printRow("HashMap", measure<HashMap<K, int>>(keys, lookups, missLookups,
+        [](HashMap<K, int>& map, const K& key, int value){ map.insert(key, value); },
+        [](HashMap<K, int>& map, const K& key) -> const int* {
+            typename HashMap<K, int>::iterator it = map.find(key);
+            return it != map.end() ? &it->second : nullptr;
+        }));
+
+    printRow("unordered_map", measure<std::unordered_map<K, int>>(keys, lookups, missLookups,
+        [](std::unordered_map<K, int>& map, const K& key, int value){ map.emplace(key, value); },
+        [](std::unordered_map<K, int>& map, const K& key) -> const int* {
+            typename std::unordered_map<K, int>::iterator it = map.find(key);
+            return it != map.end() ? &it->second : nullptr;
+        }));
+
+    //La lista es O(n) por busqueda, con muchas keys no acaba nunca
+    if (includeList){
+        printRow("lista (antigua)", measure<ListMap<K, int>>(keys, lookups, missLookups,
+            [](ListMap<K, int>& map, const K& key, int value){ map.AddNode(key, value); },
+            [](ListMap<K, int>& map, const K& key) -> const int* { return map.find(key); }));
+    }
+}
+
+//Borra la mitad de las keys mientras recorre la tabla: cada key se tiene que visitar una vez y quedar solo las que no se borran
+//Con tablas pequeñas y casi llenas los grupos de casillas dan la vuelta al final de la tabla a menudo
+static size_t checkEraseWhileIterating(){
+    Random random(99);
+    size_t failures = 0;
+
+    for (int trial = 0; trial < 20000; trial++){
+        int size = random.range(1, 200);
+        std::vector<int> keys;
+        HashMap<int, int> map;
+        for (int i = 0; i < size; i++){
+            int key = int(random.next() >> 40);
+            if (map.insert(key, 0).second)
+                keys.push_back(key);
+        }
+
+        for (HashMap<int, int>::iterator it = map.begin(); it != map.end();){
+            it->second++;
+            if (it->first % 2 != 0)
+                it = map.erase(it);
+            else
+                ++it;
+        }
+
+        bool ok = true;
+        for (int key : keys){
+            HashMap<int, int>::iterator found = map.find(key);
+            if (key % 2 != 0)
+                ok = ok && found == map.end();
+            else
+                ok = ok && found != map.end() && found->second == 1;
+        }
+        //Una key saltada se queda sin borrar o con 0, una repetida acaba con 2
+        if (!ok)
+            failures++;
+    }
+
+    return failures;
+}
+
+int main(int argc, char* argv[]){
+    size_t lookupCount = 1000000;
+    for (int i = 1; i < argc; i++){
+        if (strcmp(argv[i], "--lookups") == 0 && i + 1 < argc){
+            lookupCount = size_t(strtoull(argv[++i], nullptr, 10));
+        }
+        else{
+            printf("Uso: %s [--lookups N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (lookupCount == 0)
+        lookupCount = 1;
+
+    //El caso de la fuente: los caracteres imprimibles
+    std::vector<char> glyphs;
+    for (char c = ' '; c <= '~'; c++)
+        glyphs.push_back(c);
+    std::vector<char> glyphMisses = {'\t', '\n', '\r', char(127)};
+    run("char (fuente)", glyphs, glyphMisses, lookupCount, true);
+
+    Random random(42);
+    for (size_t size : {size_t(64), size_t(1024), size_t(100000)}){
+        std::vector<int> keys;
+        std::vector<int> misses;
+        keys.reserve(size);
+        for (size_t i = 0; i < size; i++){
+            keys.push_back(int(random.next() >> 33));
+            misses.push_back(-1 - int(random.next() >> 33));
+        }
+
+        char title[64];
+        snprintf(title, sizeof(title), "int x%zu", size);
+        run(title, keys, misses, lookupCount, size <= 1024);
+    }
+
+    std::vector<std::string> names;
+    std::vector<std::string> nameMisses;
+    for (int i = 0; i < 1024; i++){
+        names.push_back("assets/textures/tile" + std::to_string(i) + ".png");
+        nameMisses.push_back("assets/shaders/missing" + std::to_string(i) + ".glsl");
+    }
+    run("std::string x1024", names, nameMisses, lookupCount, false);
+
+    size_t failures = checkEraseWhileIterating();
+    printf("borrar mientras se recorre: %zu tablas mal\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
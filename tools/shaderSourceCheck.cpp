@@ -0,0 +1,109 @@
+#include "include/rendering/shaderSource.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+
+//Comprueba el preprocesador de shaders con archivos en memoria, sin OpenGL ni assets
+//Sale con error si algun caso no da lo esperado
+
+static int failures = 0;
+
+static void check(bool condition, const char* description){
+   printf("  %-60s %s\n", description, condition ? "ok" : "FALLA");
+   if (!condition)
+      failures++;
+}
+
+static bool preprocess(const std::map<std::string, std::string>& files, const std::string& name, std::string_view defines, ShaderSource& source){
+   return preprocessShaderWith(name, defines, [&files](const std::string& file, std::string& contents){
+      std::map<std::string, std::string>::const_iterator found = files.find(file);
+      if (found == files.end())
+         return false;
+
+      contents = found->second;
+      return true;
+   }, source);
+}
+
+static size_t occurrences(const std::string& text, const std::string& part){
+   size_t count = 0;
+   for (size_t position = text.find(part); position != std::string::npos; position = text.find(part, position + 1))
+      count++;
+   return count;
+}
+
+int main(){
+   printf("defines\n");
+   check(normalizeShaderDefines("B A=2  B") == "A=2 B", "ordenadas y sin repetir");
+   check(normalizeShaderDefines("A=2 A=3") == "A=3", "mismo nombre con otro valor: la ultima");
+   check(normalizeShaderDefines("B A=2 B A=3 A") == "A B", "la ultima aunque no tenga valor");
+   check(normalizeShaderDefines(" \t ") == "", "vacias");
+
+   std::map<std::string, std::string> files;
+   files["shader/main.vs"] =
+      "#version 330 core\n"
+      "#include \"common.glsl\"\n"
+      "#include \"lib/extra.glsl\"\n"
+      "#include \"common.glsl\"\n"
+      "void main(){}\n";
+   files["shader/common.glsl"] = "float common(){ return 1.0; }\n";
+   files["shader/lib/extra.glsl"] = "#include \"../common.glsl\"\nfloat extra(){ return 2.0; }\n";
+
+   ShaderSource source;
+   printf("#version, defines e #include\n");
+   bool ok = preprocess(files, "shader/main.vs", "B A=2 A=3", source);
+   check(ok, "se preprocesa");
+   check(source.code.rfind("#version 330 core\n#define A 3\n#define B 1\n#line 2 0\n", 0) == 0, "defines justo despues de #version");
+   check(occurrences(source.code, "#define A") == 1, "una sola #define por nombre");
+   check(occurrences(source.code, "float common()") == 1, "cada archivo se incluye una vez");
+   check(source.files.size() == 3 && source.files[1] == "shader/common.glsl" && source.files[2] == "shader/lib/extra.glsl",
+         "includes relativos a la carpeta del que incluye");
+   check(source.code.find("#line 1 1\nfloat common()") != std::string::npos, "#line al empezar un include");
+   check(source.code.find("#line 3 0\n#line 1 2\n") != std::string::npos, "#line al volver de un include");
+   check(source.code.find("#line 4 0\n\nvoid main(){}") != std::string::npos, "un include repetido deja su linea vacia");
+   check(source.code.find("#line 1 2\n\nfloat extra()") != std::string::npos, "tambien dentro de un include");
+
+   files["shader/noVersion.fs"] = "void main(){}\n";
+   ok = preprocess(files, "shader/noVersion.fs", "X", source);
+   check(ok && source.code == "#define X 1\n#line 1 0\nvoid main(){}\n", "sin #version las defines van al principio");
+
+   printf("comentarios\n");
+   files["shader/commented.fs"] =
+      "/* #version 100\n"
+      "#include \"missing.glsl\"\n"
+      "*/\n"
+      "#version 330 core\n"
+      "/* una linea */\n"
+      "#include \"common.glsl\"\n"
+      "// #include \"missing.glsl\"\n";
+   ok = preprocess(files, "shader/commented.fs", "X", source);
+   check(ok, "#include dentro de /* */ no se resuelve");
+   check(source.code.find("#include \"missing.glsl\"\n*/\n#version 330 core\n#define X 1\n") != std::string::npos,
+         "#version dentro de /* */ no cuenta");
+   check(occurrences(source.code, "float common()") == 1, "#include despues de un comentario cerrado");
+
+   printf("errores\n");
+   files["shader/broken.fs"] = "#include \"missing.glsl\"\n";
+   check(!preprocess(files, "shader/broken.fs", "", source), "falta un include");
+
+   files["shader/versionInInclude.fs"] = "#include \"versioned.glsl\"\n";
+   files["shader/versioned.glsl"] = "#version 330 core\n";
+   check(!preprocess(files, "shader/versionInInclude.fs", "", source), "#version en un include");
+
+   //Cadena de includes: depth0.glsl incluye depth1.glsl...
+   for (int i = 0; i < 20; i++)
+      files["shader/depth" + std::to_string(i) + ".glsl"] = "#include \"depth" + std::to_string(i + 1) + ".glsl\"\n";
+   files["shader/depth15.glsl"] = "float deepest;\n";
+   check(preprocess(files, "shader/depth0.glsl", "", source) && source.files.size() == 16, "16 archivos anidados");
+   files["shader/depth15.glsl"] = "#include \"depth16.glsl\"\n";
+   files["shader/depth16.glsl"] = "float deepest;\n";
+   check(!preprocess(files, "shader/depth0.glsl", "", source), "17 archivos anidados es demasiado");
+
+   if (failures != 0){
+      printf("ERROR: %d casos fallidos\n", failures);
+      return 1;
+   }
+
+   return 0;
+}
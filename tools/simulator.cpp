@@ -0,0 +1,263 @@
+#include "include/allocTracker.h"
+#include "include/bot.h"
+#include "include/policy.h"
+#include "include/replay.h"
+#include "include/simulation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Resultado de una partida
+struct GameResult{
+   int points;
+   int pieces;
+   int lines;
+   uint64_t ticks;
+   uint64_t evaluations;
+};
+
+struct Options{
+   int games = 1000;
+   int threads = 0;
+   uint64_t seed = 1;
+   int maxPieces = 10000;
+   std::string policy = "random";
+   std::string script = "LLUH";
+   std::string record;
+   std::string replay;
+};
+
+static void printUsage(){
+   std::cout << "Usage: TetrisSim [--games N] [--threads N] [--seed N] [--max-pieces N]\n"
+             << "                 [--policy random|scripted|bot] [--script LRUDH.]\n"
+             << "       TetrisSim --record FILE [--seed N] [--max-pieces N] [--policy ...]\n"
+             << "       TetrisSim --replay FILE" << std::endl;
+}
+
+static bool parseOptions(int argc, char** argv, Options& options){
+   for (int i = 1; i < argc; i++){
+      std::string arg = argv[i];
+      if (i + 1 >= argc){
+         printUsage();
+         return false;
+      }
+
+      std::string value = argv[++i];
+      if (arg == "--games")
+         options.games = std::atoi(value.c_str());
+      else if (arg == "--threads")
+         options.threads = std::atoi(value.c_str());
+      else if (arg == "--seed")
+         options.seed = std::strtoull(value.c_str(), nullptr, 10);
+      else if (arg == "--max-pieces")
+         options.maxPieces = std::atoi(value.c_str());
+      else if (arg == "--policy")
+         options.policy = value;
+      else if (arg == "--script")
+         options.script = value;
+      else if (arg == "--record")
+         options.record = value;
+      else if (arg == "--replay")
+         options.replay = value;
+      else{
+         printUsage();
+         return false;
+      }
+   }
+
+   if (options.policy != "random" && options.policy != "scripted" && options.policy != "bot"){
+      printUsage();
+      return false;
+   }
+
+   return true;
+}
+
+static std::unique_ptr<IPolicy> createPolicy(const Options& options, uint64_t seed){
+   if (options.policy == "scripted")
+      return std::unique_ptr<IPolicy>(new ScriptedPolicy(options.script));
+   if (options.policy == "bot")
+      return std::unique_ptr<IPolicy>(new Bot());
+
+   return std::unique_ptr<IPolicy>(new RandomPolicy(seed));
+}
+
+//Juega una partida entera hasta perder o llegar al limite de piezas
+static GameResult playGame(const Options& options, uint64_t seed){
+   Simulation simulation(seed);
+   std::unique_ptr<IPolicy> policy = createPolicy(options, ~seed);
+
+   //Con TRACK_ALLOCATIONS esta zona deberia quedarse en 0 reservas
+   {
+      AllocZone zone("ticks");
+      while (!simulation.state.isOver && simulation.state.piecesPlaced < options.maxPieces){
+         simulation.tick(policy->nextInput(simulation));
+      }
+   }
+
+   Bot* bot = dynamic_cast<Bot*>(policy.get());
+   uint64_t evaluations = bot ? bot->evaluatedPlacements : 0;
+
+   return GameResult{ simulation.state.points, simulation.state.piecesPlaced, simulation.state.linesCleared, simulation.state.ticks, evaluations };
+}
+
+//Graba una partida de la politica elegida
+static int recordGame(const Options& options){
+   Simulation simulation(options.seed);
+   std::unique_ptr<IPolicy> policy = createPolicy(options, ~options.seed);
+
+   ReplayRecorder recorder(options.record);
+   recorder.start(simulation.state.seed);
+
+   while (!simulation.state.isOver && simulation.state.piecesPlaced < options.maxPieces){
+      INPUT input = policy->nextInput(simulation);
+      recorder.record(simulation.state.ticks, input);
+      simulation.tick(input);
+   }
+
+   if (!recorder.finish(simulation)){
+      std::cout << "Could not write " << options.record << std::endl;
+      return 1;
+   }
+
+   std::cout << "recorded:   " << simulation.state.ticks << " ticks, " << simulation.state.piecesPlaced << " pieces, "
+             << simulation.state.points << " points" << std::endl;
+   return 0;
+}
+
+//Reproduce una repeticion sin limite de velocidad y comprueba que acaba igual
+static int playReplay(const Options& options){
+   ReplayPlayer player;
+   if (!player.load(options.replay)){
+      std::cout << "Invalid replay " << options.replay << std::endl;
+      return 1;
+   }
+
+   auto startTime = std::chrono::steady_clock::now();
+
+   Simulation simulation(player.seed);
+   while (!player.finished(simulation) && !simulation.state.isOver)
+      simulation.tick(player.nextInput(simulation));
+
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+   bool matches = player.matches(simulation);
+
+   std::cout << "replayed:   " << simulation.state.ticks << " ticks (" << double(simulation.state.ticks) / Simulation::tickRate
+             << " s of game) in " << seconds * 1000 << " ms" << std::endl;
+   std::cout << "result:     " << simulation.state.points << " points, " << simulation.state.piecesPlaced << " pieces, "
+             << (matches ? "matches the recording" : "DOES NOT match the recording") << std::endl;
+
+   return matches ? 0 : 1;
+}
+
+static int percentile(const std::vector<int>& sorted, double p){
+   size_t index = size_t(p * (sorted.size() - 1) + 0.5);
+   return sorted[index];
+}
+
+int main(int argc, char** argv){
+   Options options;
+   if (!parseOptions(argc, argv, options))
+      return 1;
+
+   if (!options.replay.empty())
+      return playReplay(options);
+   if (!options.record.empty())
+      return recordGame(options);
+
+   if (options.games <= 0)
+      return 0;
+
+   int threadCount = options.threads;
+   if (threadCount <= 0)
+      threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+   std::vector<GameResult> results(options.games);
+   std::atomic<int> nextGame(0);
+
+   //Cada hilo coge la siguiente partida libre, las partidas no comparten nada
+   auto worker = [&](){
+      while (true){
+         int game = nextGame.fetch_add(1);
+         if (game >= options.games)
+            return;
+
+         results[game] = playGame(options, options.seed + game);
+      }
+   };
+
+   auto startTime = std::chrono::steady_clock::now();
+
+   //Toda la ejecucion cuenta como un solo frame
+   AllocTracker::beginFrame();
+
+   std::vector<std::thread> threads;
+   for (int i = 0; i < threadCount; i++)
+      threads.push_back(std::thread(worker));
+   for (std::thread& thread : threads)
+      thread.join();
+
+   AllocTracker::endFrame();
+
+   double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+   //Estadisticas
+   uint64_t totalPieces = 0;
+   uint64_t totalLines = 0;
+   uint64_t totalTicks = 0;
+   uint64_t totalEvaluations = 0;
+   double totalPoints = 0;
+   std::vector<int> scores;
+   for (const GameResult& result : results){
+      totalPieces += result.pieces;
+      totalLines += result.lines;
+      totalTicks += result.ticks;
+      totalEvaluations += result.evaluations;
+      totalPoints += result.points;
+      scores.push_back(result.points);
+   }
+   std::sort(scores.begin(), scores.end());
+
+   std::cout << "games:      " << options.games << " (" << threadCount << " threads, policy " << options.policy << ")" << std::endl;
+   std::cout << "time:       " << seconds << " s" << std::endl;
+   std::cout << "games/sec:  " << options.games / seconds << std::endl;
+   std::cout << "pieces/sec: " << totalPieces / seconds << std::endl;
+   std::cout << "ticks/sec:  " << totalTicks / seconds << std::endl;
+   if (totalEvaluations > 0)
+      std::cout << "placements: " << totalEvaluations / (seconds * 1000) << " per ms" << std::endl;
+   std::cout << "pieces:     " << double(totalPieces) / options.games << " per game" << std::endl;
+   std::cout << "lines:      " << double(totalLines) / options.games << " per game" << std::endl;
+   std::cout << "score:      mean " << totalPoints / options.games
+             << " min " << scores.front()
+             << " p50 " << percentile(scores, 0.5)
+             << " p90 " << percentile(scores, 0.9)
+             << " p99 " << percentile(scores, 0.99)
+             << " max " << scores.back() << std::endl;
+
+   //Histograma de puntuaciones en 10 intervalos
+   int bucketSize = std::max(1, (scores.back() - scores.front()) / 10 + 1);
+   std::vector<int> buckets(10, 0);
+   for (int score : scores)
+      buckets[std::min(9, (score - scores.front()) / bucketSize)]++;
+
+   for (int i = 0; i < 10; i++){
+      int from = scores.front() + i * bucketSize;
+      std::cout << "  [" << from << ", " << from + bucketSize << "): " << buckets[i] << std::endl;
+   }
+
+   if (AllocTracker::enabled()){
+      std::cout << std::flush;
+      AllocTracker::printReport(stdout);
+   }
+
+   return 0;
+}
@@ -0,0 +1,178 @@
+#include "include/random.h"
+#include "include/rendering/spriteStore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//Lo mismo que SpriteStore::pick pero mirando todos los sprites
+static size_t linearPick(const SpriteStore& sprites, const std::vector<SpriteHandle>& handles, glm::vec2 point){
+   size_t found = 0;
+   for (SpriteHandle handle : handles){
+      glm::vec2 position = sprites.getPosition(handle);
+      glm::vec2 scale = sprites.getScale(handle);
+      float radians = sprites.getRotation(handle) * 3.14159265358979323846f / 180.0f;
+      glm::vec2 offset = point - position;
+      glm::vec2 local(std::cos(radians) * offset.x + std::sin(radians) * offset.y, -std::sin(radians) * offset.x + std::cos(radians) * offset.y);
+      if (std::fabs(local.x) <= scale.x * 0.5f && std::fabs(local.y) <= scale.y * 0.5f)
+         found++;
+   }
+   return found;
+}
+
+//Caja del sprite, igual que la del indice
+static void bounds(const SpriteStore& sprites, SpriteHandle handle, glm::vec2& min, glm::vec2& max){
+   glm::vec2 scale = sprites.getScale(handle);
+   float radians = sprites.getRotation(handle) * 3.14159265358979323846f / 180.0f;
+   float sine = std::fabs(std::sin(radians));
+   float cosine = std::fabs(std::cos(radians));
+   glm::vec2 half = glm::vec2(cosine * scale.x + sine * scale.y, sine * scale.x + cosine * scale.y) * 0.5f;
+   min = sprites.getPosition(handle) - half;
+   max = sprites.getPosition(handle) + half;
+}
+
+static size_t linearRect(const SpriteStore& sprites, const std::vector<SpriteHandle>& handles, glm::vec2 rectMin, glm::vec2 rectMax){
+   size_t found = 0;
+   for (SpriteHandle handle : handles){
+      glm::vec2 min, max;
+      bounds(sprites, handle, min, max);
+      if (max.x >= rectMin.x && min.x <= rectMax.x && max.y >= rectMin.y && min.y <= rectMax.y)
+         found++;
+   }
+   return found;
+}
+
+//Distancia del k-esimo mas cercano
+static float linearNearest(const SpriteStore& sprites, const std::vector<SpriteHandle>& handles, glm::vec2 point, size_t k, std::vector<float>& distances){
+   distances.clear();
+   for (SpriteHandle handle : handles){
+      glm::vec2 min, max;
+      bounds(sprites, handle, min, max);
+      float dx = std::max(std::max(min.x - point.x, point.x - max.x), 0.0f);
+      float dy = std::max(std::max(min.y - point.y, point.y - max.y), 0.0f);
+      distances.push_back(std::sqrt(dx * dx + dy * dy));
+   }
+   std::nth_element(distances.begin(), distances.begin() + (k - 1), distances.end());
+   return distances[k - 1];
+}
+
+template<typename Function>
+static double nsPerCall(int calls, Function&& function){
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   for (int i = 0; i < calls; i++)
+      function(i);
+   return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+}
+
+int main(int argc, char* argv[]){
+   int count = 100000;
+   float world = 20000;
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--sprites") == 0 && i + 1 < argc){
+         count = atoi(argv[++i]);
+      }else if (strcmp(argv[i], "--world") == 0 && i + 1 < argc){
+         world = float(atof(argv[++i]));
+      }else{
+         printf("Uso: %s [--sprites N] [--world LADO]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   Random random(11);
+   auto randomPoint = [&](){ return glm::vec2(float(random.range(0, int(world))), float(random.range(0, int(world)))); };
+
+   SpriteStore sprites;
+   std::vector<SpriteHandle> handles;
+   double addNs = nsPerCall(count, [&](int i){
+      glm::vec2 position = randomPoint();
+      SpriteHandle handle = sprites.add(1, position.x, position.y, float(random.range(8, 64)), float(random.range(8, 64)), uint8_t(i % 4));
+      if (i % 3 == 0)
+         sprites.setRotation(handle, float(random.range(0, 359)));
+      handles.push_back(handle);
+   });
+
+   //Un fondo que lo tapa todo, va a la lista de grandes
+   handles.push_back(sprites.add(1, world * 0.5f, world * 0.5f, world, world, 0));
+
+   printf("%d sprites en %.0fx%.0f pixeles, add %.0f ns\n", count, world, world, addNs);
+
+   //Tantos movimientos pequeños como sprites, cada uno a un sprite al azar
+   double moveNs = nsPerCall(count, [&](int){
+      SpriteHandle handle = handles[size_t(random.next() % size_t(count))];
+      glm::vec2 position = sprites.getPosition(handle);
+      sprites.setPosition(handle, position.x + float(random.range(-4, 4)), position.y + float(random.range(-4, 4)));
+   });
+   printf("  setPosition %.0f ns\n", moveNs);
+
+   //Comprueba contra recorrerlo todo
+   const size_t capacity = 256;
+   SpriteHandle results[capacity];
+   std::vector<float> distances;
+   int mismatches = 0;
+   for (int i = 0; i < 200; i++){
+      glm::vec2 point = randomPoint();
+      glm::vec2 size(float(random.range(50, 500)), float(random.range(50, 500)));
+
+      if (sprites.pick(point, results, capacity) != linearPick(sprites, handles, point))
+         mismatches++;
+      if (sprites.queryRect(point, point + size, results, capacity) != linearRect(sprites, handles, point, point + size))
+         mismatches++;
+
+      size_t found = sprites.nearest(point, 8, results);
+      glm::vec2 min, max;
+      bounds(sprites, results[found - 1], min, max);
+      float dx = std::max(std::max(min.x - point.x, point.x - max.x), 0.0f);
+      float dy = std::max(std::max(min.y - point.y, point.y - max.y), 0.0f);
+      if (found != 8 || std::sqrt(dx * dx + dy * dy) != linearNearest(sprites, handles, point, 8, distances))
+         mismatches++;
+   }
+   printf("  comprobacion contra recorrido lineal: %d diferencias\n", mismatches);
+
+   //El fondo hace que pick siempre encuentre algo, se quita para medir solo lo que esta en la rejilla
+   sprites.remove(handles.back());
+   handles.pop_back();
+
+   const int queries = 20000;
+   size_t sink = 0;
+   double pickNs = nsPerCall(queries, [&](int){ sink += sprites.pick(randomPoint(), results, capacity); });
+   double rectNs = nsPerCall(queries, [&](int){ glm::vec2 p = randomPoint(); sink += sprites.queryRect(p, p + glm::vec2(256, 256), results, capacity); });
+   double nearestNs = nsPerCall(queries, [&](int){ sink += sprites.nearest(randomPoint(), 8, results); });
+   double linearNs = nsPerCall(200, [&](int){ sink += linearPick(sprites, handles, randomPoint()); });
+
+   printf("  pick %.0f ns, rect 256x256 %.0f ns, 8 mas cercanos %.0f ns\n", pickNs, rectNs, nearestNs);
+   printf("  pick recorriendo todos %.0f ns (x%.0f)\n", linearNs, linearNs / pickNs);
+
+   //Menos sprites que k, y uno que se aparta muy lejos y vuelve: las consultas no pueden quedarse recorriendo esa zona
+   SpriteStore few;
+   std::vector<SpriteHandle> fewHandles;
+   for (int i = 0; i < 3; i++)
+      fewHandles.push_back(few.add(1, 100.0f + 50.0f * i, 100, 32, 32, 0));
+
+   few.setPosition(fewHandles[0], 2e6f, 2e6f);
+   few.setPosition(fewHandles[0], 100, 100);
+
+   size_t fewFound = 0;
+   double fewNearestNs = nsPerCall(1000, [&](int){ fewFound = few.nearest(randomPoint(), 8, results); });
+   if (fewFound != 3)
+      mismatches++;
+   double fewRectNs = nsPerCall(1000, [&](int){ fewFound = few.queryRect(glm::vec2(-1e7f, -1e7f), glm::vec2(1e7f, 1e7f), results, capacity); });
+   if (fewFound != 3)
+      mismatches++;
+
+   printf("  3 sprites, uno apartado y devuelto: 8 mas cercanos %.0f ns, rect de todo el mundo %.0f ns\n", fewNearestNs, fewRectNs);
+
+   //Sin reducir la zona usada cada consulta tardaba segundos
+   if (fewNearestNs > 1e6 || fewRectNs > 1e6)
+      mismatches++;
+
+   if (mismatches != 0){
+      printf("ERROR: %d comprobaciones fallidas\n", mismatches);
+      return 1;
+   }
+
+   return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+#include "include/assetPack.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+//Los tiempos de una fase en todas las pasadas
+struct PhaseSamples{
+   std::string name;
+   std::vector<double> selfMs;
+};
+
+struct Summary{
+   double median;
+   double mean;
+   double variance;
+};
+
+//Mediana, media y varianza muestral
+static Summary summarize(std::vector<double> samples){
+   Summary summary = { 0, 0, 0 };
+   if (samples.empty())
+      return summary;
+
+   std::sort(samples.begin(), samples.end());
+   size_t middle = samples.size() / 2;
+   summary.median = samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+
+   for (double sample : samples)
+      summary.mean += sample;
+   summary.mean /= double(samples.size());
+
+   if (samples.size() > 1){
+      for (double sample : samples)
+         summary.variance += (sample - summary.mean) * (sample - summary.mean);
+      summary.variance /= double(samples.size() - 1);
+   }
+
+   return summary;
+}
+
+//Arranca el juego con --startup-trace y espera a que se cierre, devuelve el tiempo de reloj del proceso
+static bool runGame(const std::string& game, const std::string& report, double& processMs){
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+   pid_t child = fork();
+   if (child < 0)
+      return false;
+
+   if (child == 0){
+      execl(game.c_str(), game.c_str(), "--startup-trace", report.c_str(), (char*)nullptr);
+      _exit(127);
+   }
+
+   int status = 0;
+   if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+      return false;
+
+   processMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+   return true;
+}
+
+//El informe tiene una fase por linea, ver StartupTrace::finish
+static bool readReport(const std::string& path, double& totalMs, double& otherMs, std::vector<PhaseSamples>& phases){
+   FILE* file = fopen(path.c_str(), "r");
+   if (file == nullptr)
+      return false;
+
+   bool hasTotal = false;
+   char line[512];
+   while (fgets(line, sizeof(line), file)){
+      char name[128];
+      unsigned int calls;
+      double ms, selfMs;
+
+      if (sscanf(line, " \"totalMs\": %lf", &totalMs) == 1){
+         hasTotal = true;
+      }else if (sscanf(line, " \"otherMs\": %lf", &otherMs) == 1){
+      }else if (sscanf(line, " {\"name\": \"%127[^\"]\", \"calls\": %u, \"ms\": %lf, \"selfMs\": %lf", name, &calls, &ms, &selfMs) == 4){
+         std::vector<PhaseSamples>::iterator phase = std::find_if(phases.begin(), phases.end(), [&](const PhaseSamples& samples){ return samples.name == name; });
+         if (phase == phases.end()){
+            phases.push_back(PhaseSamples{ name, {} });
+            phase = phases.end() - 1;
+         }
+         phase->selfMs.push_back(selfMs);
+      }
+   }
+
+   fclose(file);
+   return hasTotal;
+}
+
+static void printRow(const char* name, const std::vector<double>& samples){
+   Summary summary = summarize(samples);
+   printf("  %-12s %9.3f %9.3f %11.3f %9.3f\n", name, summary.median, summary.mean, summary.variance, std::sqrt(summary.variance));
+}
+
+int main(int argc, char* argv[]){
+   int runs = 10;
+   int warmup = 1;
+   std::string game = executableDirectory() + "TetrisOpenGL";
+
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc){
+         runs = atoi(argv[++i]);
+      }else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc){
+         warmup = atoi(argv[++i]);
+      }else if (strcmp(argv[i], "--game") == 0 && i + 1 < argc){
+         game = argv[++i];
+      }else{
+         printf("Uso: %s [--runs N] [--warmup N] [--game TetrisOpenGL]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   if (runs < 1){
+      printf("--runs tiene que ser al menos 1\n");
+      return 1;
+   }
+
+   std::string report = "/tmp/tetrisStartup." + std::to_string(getpid()) + ".json";
+
+   //Las pasadas de calentamiento llenan la cache de shaders y la cache de disco del sistema
+   for (int i = 0; i < warmup; i++){
+      double processMs;
+      if (!runGame(game, report, processMs)){
+         printf("No se puede ejecutar %s\n", game.c_str());
+         return 1;
+      }
+   }
+
+   std::vector<PhaseSamples> phases;
+   std::vector<double> totals, others, processes;
+   for (int i = 0; i < runs; i++){
+      double processMs, totalMs = 0, otherMs = 0;
+      if (!runGame(game, report, processMs) || !readReport(report, totalMs, otherMs, phases)){
+         printf("La pasada %d ha fallado\n", i + 1);
+         remove(report.c_str());
+         return 1;
+      }
+
+      totals.push_back(totalMs);
+      others.push_back(otherMs);
+      processes.push_back(processMs);
+   }
+   remove(report.c_str());
+
+   //Tiempo propio de cada fase, sin las fases de dentro
+   printf("%d pasadas, ms\n", runs);
+   printf("  %-12s %9s %9s %11s %9s\n", "fase", "mediana", "media", "varianza", "desv");
+   for (const PhaseSamples& phase : phases)
+      printRow(phase.name.c_str(), phase.selfMs);
+   printRow("otro", others);
+   printRow("primerFrame", totals);
+   printRow("proceso", processes);
+
+   return 0;
+}
@@ -0,0 +1,102 @@
+#include "include/random.h"
+#include "include/rendering/tilemap.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//Lo que hace TilemapRenderer en cada frame sin la parte de OpenGL: buscar los chunks visibles y rehacer los que han cambiado
+//Mide el tiempo por frame de un mapa grande con la vista moviendose y tiles cambiando por todo el mapa
+int main(int argc, char* argv[]){
+   uint32_t size = 4096;
+   int frames = 2000;
+   int edits = 256;
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--size") == 0 && i + 1 < argc){
+         size = uint32_t(atoi(argv[++i]));
+      }else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc){
+         frames = atoi(argv[++i]);
+      }else if (strcmp(argv[i], "--edits") == 0 && i + 1 < argc){
+         edits = atoi(argv[++i]);
+      }else{
+         printf("Uso: %s [--size LADO] [--frames N] [--edits POR_FRAME]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   const float tileSize = 8;
+   const glm::vec2 view(1280, 720);
+   Random random(7);
+
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   Tilemap map(size, size, tileSize, glm::vec2(0, 0));
+   for (uint32_t y = 0; y < size; y++){
+      for (uint32_t x = 0; x < size; x++)
+         map.setTile(x, y, uint16_t(random.range(0, 7)));
+   }
+   double fillMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+   printf("%ux%u tiles (%.1f M), %u chunks, rellenar %.1f ms\n", size, size, double(size) * size / 1e6, map.chunkCount(), fillMs);
+
+   //La revision que tendria el renderizador de cada chunk
+   std::vector<uint32_t> built(map.chunkCount(), 0);
+   std::vector<TileInstance> instances;
+   std::vector<TileRange> ranges;
+
+   std::vector<double> frameMs;
+   uint64_t visible = 0, rebuilt = 0, tilesDrawn = 0;
+   float mapPixels = float(size) * tileSize;
+
+   for (int frame = 0; frame < frames; frame++){
+      //Cambios por todo el mapa, la mayoria fuera de la vista
+      for (int i = 0; i < edits; i++)
+         map.setTile(uint32_t(random.range(0, int(size) - 1)), uint32_t(random.range(0, int(size) - 1)), uint16_t(random.range(0, 7)));
+
+      //La vista recorre el mapa en diagonal
+      float offset = float(frame) * 3.0f;
+      glm::vec2 viewMin(std::fmod(offset, mapPixels - view.x), std::fmod(offset * 0.5f, mapPixels - view.y));
+
+      std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+
+      uint32_t x0, y0, x1, y1;
+      if (map.chunksInRect(viewMin, viewMin + view, x0, y0, x1, y1)){
+         for (uint32_t chunkY = y0; chunkY < y1; chunkY++){
+            for (uint32_t chunkX = x0; chunkX < x1; chunkX++){
+               uint32_t chunk = chunkY * map.chunksX() + chunkX;
+               visible++;
+
+               if (built[chunk] != map.chunkRevision(chunk)){
+                  map.buildChunk(chunk, instances, ranges);
+                  built[chunk] = map.chunkRevision(chunk);
+                  rebuilt++;
+               }
+               tilesDrawn += TILEMAP_CHUNK_TILES;
+            }
+         }
+      }
+
+      frameMs.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
+   }
+
+   std::sort(frameMs.begin(), frameMs.end());
+   printf("%d frames, vista %.0fx%.0f, %d cambios por frame\n", frames, view.x, view.y, edits);
+   printf("  chunks visibles %.1f/frame, rehechos %.2f/frame\n", double(visible) / frames, double(rebuilt) / frames);
+   printf("  frame: mediana %.4f ms  p99 %.4f ms  max %.4f ms\n", frameMs[frameMs.size() / 2], frameMs[frameMs.size() * 99 / 100], frameMs.back());
+
+   //Lo mismo sin chunks: rehacer todos los tiles visibles en cada frame
+   start = std::chrono::steady_clock::now();
+   uint32_t x0, y0, x1, y1;
+   map.chunksInRect(glm::vec2(0, 0), view, x0, y0, x1, y1);
+   for (int frame = 0; frame < 100; frame++){
+      for (uint32_t chunkY = y0; chunkY < y1; chunkY++){
+         for (uint32_t chunkX = x0; chunkX < x1; chunkX++)
+            map.buildChunk(chunkY * map.chunksX() + chunkX, instances, ranges);
+      }
+   }
+   printf("  rehaciendo toda la vista cada frame: %.4f ms\n", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / 100);
+
+   return 0;
+}
@@ -0,0 +1,161 @@
+#include "include/random.h"
+#include "include/rendering/transformKernel.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//Matrices con std::sin y std::cos, para medir el error de los polinomios
+static void buildReference(const std::vector<glm::vec2>& positions, const std::vector<glm::vec2>& scales, const std::vector<float>& rotations, std::vector<Affine2D>& out){
+   for (size_t i = 0; i < positions.size(); i++){
+      double radians = double(rotations[i]) * 3.14159265358979323846 / 180.0;
+      float c = float(std::cos(radians));
+      float s = float(std::sin(radians));
+
+      out[i] = Affine2D{ c * scales[i].x, s * scales[i].x, -s * scales[i].y, c * scales[i].y, positions[i].x, positions[i].y };
+   }
+}
+
+//Mayor diferencia relativa a la escala, la traslacion tiene que ser exacta
+static double maxError(const std::vector<Affine2D>& a, const std::vector<Affine2D>& b, const std::vector<glm::vec2>& scales){
+   double worst = 0;
+   for (size_t i = 0; i < a.size(); i++){
+      worst = std::max(worst, std::fabs(double(a[i].a) - double(b[i].a)) / scales[i].x);
+      worst = std::max(worst, std::fabs(double(a[i].b) - double(b[i].b)) / scales[i].x);
+      worst = std::max(worst, std::fabs(double(a[i].c) - double(b[i].c)) / scales[i].y);
+      worst = std::max(worst, std::fabs(double(a[i].d) - double(b[i].d)) / scales[i].y);
+
+      if (a[i].tx != b[i].tx || a[i].ty != b[i].ty)
+         return INFINITY;
+   }
+
+   return worst;
+}
+
+//Cuantas matrices no son identicas bit a bit a las de la version escalar
+static size_t differences(const std::vector<Affine2D>& a, const std::vector<Affine2D>& b){
+   size_t count = 0;
+   for (size_t i = 0; i < a.size(); i++){
+      if (memcmp(&a[i], &b[i], sizeof(Affine2D)) != 0)
+         count++;
+   }
+   return count;
+}
+
+//Rotaciones que no salen al azar: multiplos de 90, limites del recorte, infinitos y NaN
+//37 sprites para que SSE y AVX tambien pasen por el resto escalar
+static std::vector<float> edgeRotations(){
+   std::vector<float> rotations = { 0.0f, -0.0f, 45.0f, 90.0f, -90.0f, 180.0f, 270.0f, 360.0f, -360.0f, 720.5f, 1e7f, -1e7f, 1e8f, -1e8f,
+                                    1.5e8f, 2.2e9f, -2.2e9f, 1e30f, -1e30f, INFINITY, -INFINITY, NAN, -NAN, 3.4e38f, -3.4e38f, 1e-30f };
+   while (rotations.size() < 37)
+      rotations.push_back(float(rotations.size()) * 33.3f);
+   return rotations;
+}
+
+int main(int argc, char* argv[]){
+   double minSeconds = 0.25;
+   for (int i = 1; i < argc; i++){
+      if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc){
+         minSeconds = atof(argv[++i]);
+      }else{
+         printf("Uso: %s [--seconds S]\n", argv[0]);
+         return 1;
+      }
+   }
+
+   const TRANSFORM_KERNEL kernels[] = { kernelScalar, kernelSSE, kernelAVX };
+   Random random(7);
+
+   printf("mejor implementacion: %s\n", transformKernelName(bestTransformKernel()));
+
+   //Todas las versiones tienen que dar exactamente lo mismo que la escalar
+   size_t mismatches = 0;
+   {
+      std::vector<float> rotations = edgeRotations();
+      std::vector<glm::vec2> positions(rotations.size(), glm::vec2(100, 200));
+      std::vector<glm::vec2> scales(rotations.size(), glm::vec2(32, 16));
+      std::vector<Affine2D> scalar(rotations.size());
+      std::vector<Affine2D> out(rotations.size());
+      buildTransforms(positions.data(), scales.data(), rotations.data(), scalar.data(), rotations.size(), kernelScalar);
+
+      for (size_t i = 0; i < scalar.size(); i++){
+         if (!std::isfinite(scalar[i].a) || !std::isfinite(scalar[i].b)){
+            printf("  rotacion %g: matriz no finita\n", double(rotations[i]));
+            mismatches++;
+         }
+      }
+
+      for (TRANSFORM_KERNEL kernel : kernels){
+         if (kernel == kernelScalar || !transformKernelAvailable(kernel))
+            continue;
+
+         buildTransforms(positions.data(), scales.data(), rotations.data(), out.data(), rotations.size(), kernel);
+         size_t different = differences(out, scalar);
+         printf("  %-7s casos limite distintos de escalar: %zu\n", transformKernelName(kernel), different);
+         mismatches += different;
+      }
+   }
+
+   for (size_t count : {size_t(10000), size_t(100000), size_t(1000000)}){
+      std::vector<glm::vec2> positions(count);
+      std::vector<glm::vec2> scales(count);
+      std::vector<float> rotations(count);
+      for (size_t i = 0; i < count; i++){
+         positions[i] = glm::vec2(random.range(0, 800), random.range(0, 800));
+         scales[i] = glm::vec2(random.range(8, 64), random.range(8, 64));
+         rotations[i] = float(random.range(-3600000, 3600000)) / 1000.0f;
+      }
+
+      std::vector<Affine2D> reference(count);
+      std::vector<Affine2D> out(count);
+      buildReference(positions, scales, rotations, reference);
+
+      printf("%zu sprites\n", count);
+
+      std::vector<Affine2D> scalar(count);
+      buildTransforms(positions.data(), scales.data(), rotations.data(), scalar.data(), count, kernelScalar);
+
+      double scalarNs = 0;
+      for (TRANSFORM_KERNEL kernel : kernels){
+         if (!transformKernelAvailable(kernel)){
+            printf("  %-7s no disponible\n", transformKernelName(kernel));
+            continue;
+         }
+
+         //Repite hasta llenar el tiempo minimo, se queda con la mejor pasada
+         double best = INFINITY;
+         double total = 0;
+         int passes = 0;
+         while (total < minSeconds || passes < 3){
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            buildTransforms(positions.data(), scales.data(), rotations.data(), out.data(), count, kernel);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            best = std::min(best, seconds);
+            total += seconds;
+            passes++;
+         }
+
+         double nsPerSprite = best * 1e9 / double(count);
+         if (kernel == kernelScalar)
+            scalarNs = nsPerSprite;
+
+         size_t different = differences(out, scalar);
+         mismatches += different;
+
+         printf("  %-7s %7.3f ns/sprite %9.1f Msprites/s  x%.2f  error max %.2e  distintas de escalar %zu\n", transformKernelName(kernel), nsPerSprite,
+                double(count) / best / 1e6, scalarNs / nsPerSprite, maxError(out, reference, scales), different);
+      }
+   }
+
+   if (mismatches != 0){
+      printf("ERROR: %zu matrices distintas entre versiones\n", mismatches);
+      return 1;
+   }
+
+   return 0;
+}